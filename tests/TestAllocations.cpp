@@ -0,0 +1,249 @@
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include "raccoon-ecs/entity_manager.h"
+
+#include "tests/utils/allocation_counter.h"
+
+namespace TestAllocations_Internal
+{
+	enum ComponentType
+	{
+		TransformComponentId,
+		MovementComponentId,
+	};
+
+	using ComponentFactory = RaccoonEcs::ComponentFactoryImpl<ComponentType>;
+	using EntityManager = RaccoonEcs::EntityManagerImpl<ComponentType>;
+	using Entity = RaccoonEcs::Entity;
+	using ScopedAllocationCounter = AllocationCounter::ScopedAllocationCounter;
+
+	struct TransformComponent
+	{
+		int x;
+		int y;
+
+		static ComponentType GetTypeId() { return TransformComponentId; };
+	};
+
+	struct MovementComponent
+	{
+		int dx;
+		int dy;
+
+		static ComponentType GetTypeId() { return MovementComponentId; };
+	};
+
+	struct EntityManagerData
+	{
+		ComponentFactory componentFactory;
+		EntityManager entityManager{componentFactory};
+	};
+
+	static void RegisterComponents(ComponentFactory& inOutFactory)
+	{
+		inOutFactory.registerComponent<TransformComponent>();
+		inOutFactory.registerComponent<MovementComponent>();
+	}
+
+	static std::unique_ptr<EntityManagerData> PrepareEntityManager()
+	{
+		auto data = std::make_unique<EntityManagerData>();
+		RegisterComponents(data->componentFactory);
+		return data;
+	}
+
+	static std::vector<Entity> addEntities(EntityManager& entityManager, int count)
+	{
+		std::vector<Entity> result;
+		for (int i = 0; i < count; ++i)
+		{
+			const Entity entity = entityManager.addEntity();
+			entityManager.addComponent<TransformComponent>(entity)->x = i;
+			if (i % 2 == 0)
+			{
+				entityManager.addComponent<MovementComponent>(entity)->dx = 1;
+			}
+			result.push_back(entity);
+		}
+		return result;
+	}
+
+	// upper bound of allocations for one executeScheduledActions call after the queues have warmed up
+	constexpr size_t MaxScheduledActionsAllocations = 2;
+} // namespace EntityManagerTestInternals
+
+TEST(AllocationCounter, AllocateOnCurrentThread_AllocationIsCounted)
+{
+	using namespace TestAllocations_Internal;
+
+	ScopedAllocationCounter counter;
+	{
+		std::vector<int> values(10);
+	}
+	EXPECT_EQ(static_cast<size_t>(1), counter.getAllocationsCount());
+	EXPECT_EQ(static_cast<size_t>(1), counter.getDeallocationsCount());
+}
+
+TEST(AllocationCounter, AllocateOnOtherThread_AllocationIsNotCounted)
+{
+	using namespace TestAllocations_Internal;
+
+	size_t otherThreadAllocationsCount = 0;
+
+	std::thread worker([&otherThreadAllocationsCount]() {
+		ScopedAllocationCounter workerCounter;
+		std::vector<int> values(10);
+		otherThreadAllocationsCount = workerCounter.getAllocationsCount();
+	});
+
+	// starting the thread allocates on this thread, so measuring starts after that
+	ScopedAllocationCounter counter;
+	worker.join();
+
+	EXPECT_EQ(static_cast<size_t>(0), counter.getAllocationsCount());
+	EXPECT_EQ(static_cast<size_t>(1), otherThreadAllocationsCount);
+}
+
+TEST(EntityManager, SteadyState_ForEachComponentSet_NothingIsAllocated)
+{
+	using namespace TestAllocations_Internal;
+
+	auto entityManagerData = PrepareEntityManager();
+	EntityManager& entityManager = entityManagerData->entityManager;
+	addEntities(entityManager, 1000);
+
+	ScopedAllocationCounter counter;
+
+	entityManager.forEachComponentSet<TransformComponent, MovementComponent>([](TransformComponent* transform, MovementComponent* movement) {
+		transform->x += movement->dx;
+	});
+	entityManager.forEachComponentSetWithEntity<TransformComponent>([](Entity, TransformComponent* transform) {
+		transform->y = transform->x;
+	});
+
+	EXPECT_EQ(static_cast<size_t>(0), counter.getAllocationsCount());
+}
+
+TEST(EntityManager, SteadyState_ForEachComponentSetWithIndex_NothingIsAllocated)
+{
+	using namespace TestAllocations_Internal;
+
+	auto entityManagerData = PrepareEntityManager();
+	EntityManager& entityManager = entityManagerData->entityManager;
+	entityManager.initIndex<TransformComponent, MovementComponent>();
+	addEntities(entityManager, 1000);
+
+	ScopedAllocationCounter counter;
+
+	entityManager.forEachComponentSet<TransformComponent, MovementComponent>([](TransformComponent* transform, MovementComponent* movement) {
+		transform->x += movement->dx;
+	});
+
+	EXPECT_EQ(static_cast<size_t>(0), counter.getAllocationsCount());
+}
+
+TEST(EntityManager, SteadyState_GetComponentsIntoReservedVector_NothingIsAllocated)
+{
+	using namespace TestAllocations_Internal;
+
+	auto entityManagerData = PrepareEntityManager();
+	EntityManager& entityManager = entityManagerData->entityManager;
+	addEntities(entityManager, 1000);
+
+	std::vector<std::tuple<TransformComponent*, MovementComponent*>> components;
+	components.reserve(1000);
+	std::vector<std::tuple<Entity, TransformComponent*>> componentsWithEntities;
+	componentsWithEntities.reserve(1000);
+
+	ScopedAllocationCounter counter;
+
+	entityManager.getComponents<TransformComponent, MovementComponent>(components);
+	entityManager.getComponentsWithEntities<TransformComponent>(componentsWithEntities);
+
+	EXPECT_EQ(static_cast<size_t>(0), counter.getAllocationsCount());
+	EXPECT_EQ(static_cast<size_t>(500), components.size());
+	EXPECT_EQ(static_cast<size_t>(1000), componentsWithEntities.size());
+}
+
+TEST(EntityManager, SteadyState_IterateOverView_NothingIsAllocated)
+{
+	using namespace TestAllocations_Internal;
+
+	auto entityManagerData = PrepareEntityManager();
+	EntityManager& entityManager = entityManagerData->entityManager;
+	addEntities(entityManager, 1000);
+
+	int sum = 0;
+	ScopedAllocationCounter counter;
+
+	for (auto [transform, movement] : entityManager.view<TransformComponent, MovementComponent>())
+	{
+		sum += transform->x + movement->dx;
+	}
+
+	EXPECT_EQ(static_cast<size_t>(0), counter.getAllocationsCount());
+	EXPECT_EQ(250000, sum);
+}
+
+TEST(EntityManager, SteadyState_GetEntityComponents_NothingIsAllocated)
+{
+	using namespace TestAllocations_Internal;
+
+	auto entityManagerData = PrepareEntityManager();
+	EntityManager& entityManager = entityManagerData->entityManager;
+	const std::vector<Entity> entities = addEntities(entityManager, 100);
+
+	int sum = 0;
+	ScopedAllocationCounter counter;
+
+	for (const Entity entity : entities)
+	{
+		auto [transform] = entityManager.getEntityComponents<TransformComponent>(entity);
+		sum += transform->x;
+	}
+
+	EXPECT_EQ(static_cast<size_t>(0), counter.getAllocationsCount());
+	EXPECT_EQ(4950, sum);
+}
+
+TEST(EntityManager, SteadyState_ExecuteScheduledActions_AllocationsAreBounded)
+{
+	using namespace TestAllocations_Internal;
+
+	// the same bound for both sizes, so allocations that grow with the number of actions fail on the bigger one
+	for (const int entitiesCount : {20, 2000})
+	{
+		SCOPED_TRACE(entitiesCount);
+
+		auto entityManagerData = PrepareEntityManager();
+		EntityManager& entityManager = entityManagerData->entityManager;
+		const std::vector<Entity> entities = addEntities(entityManager, entitiesCount);
+
+		const auto runFrame = [&entityManager, &entities]() {
+			for (const Entity entity : entities)
+			{
+				entityManager.scheduleRemoveComponent<TransformComponent>(entity);
+			}
+			entityManager.executeScheduledActions();
+			for (const Entity entity : entities)
+			{
+				entityManager.scheduleAddComponent<TransformComponent>(entity);
+			}
+			entityManager.executeScheduledActions();
+		};
+
+		// the first frame grows the queues and pools to their working size
+		runFrame();
+
+		for (int frame = 0; frame < 3; ++frame)
+		{
+			ScopedAllocationCounter counter;
+			runFrame();
+			EXPECT_LE(counter.getAllocationsCount(), 2 * MaxScheduledActionsAllocations);
+		}
+	}
+}
@@ -1,6 +1,8 @@
 #include <gtest/gtest.h>
 
 #include <functional>
+#include <optional>
+#include <ranges>
 #include <vector>
 
 #include "raccoon-ecs/entity_manager.h"
@@ -461,4 +463,200 @@ TEST(CombinedEntityManagerView, CombinedEntityManagerView_ExecuteScheduledAction
 		entityManagerData->combinedEntityManager.getAllEntityComponents(testEntity2, components);
 		EXPECT_EQ(static_cast<size_t>(1u), components.size());
 	}
-}
\ No newline at end of file
+}
+
+TEST(CombinedEntityManagerView, ComponentSetsCanBeIteratedOverWithView)
+{
+	using namespace TestCombinedEntityManagerView_Internal;
+
+	auto entityManagerData = PrepareEntityManager();
+	EntityManager& entityManager1 = entityManagerData->entityManager1;
+	EntityManager& entityManager2 = entityManagerData->entityManager2;
+	CombinedEntityManagerView& combinedEntityManager = entityManagerData->combinedEntityManager;
+
+	const Entity testEntity1 = entityManager1.addEntity();
+	entityManager1.addComponent<TransformComponent>(testEntity1);
+	entityManager1.addComponent<MovementComponent>(testEntity1);
+
+	const Entity testEntity2 = entityManager2.addEntity();
+	entityManager2.addComponent<TransformComponent>(testEntity2);
+	entityManager2.addComponent<EmptyComponent>(testEntity2);
+
+	static_assert(std::ranges::forward_range<decltype(combinedEntityManager.view<TransformComponent>())>);
+
+	{
+		int iterationsCount = 0;
+		for (auto [movement] : combinedEntityManager.view<MovementComponent>())
+		{
+			EXPECT_NE(nullptr, movement);
+			++iterationsCount;
+		}
+		EXPECT_EQ(1, iterationsCount);
+	}
+
+	{
+		int iterationsCount = 0;
+		for (auto [transform] : combinedEntityManager.view<TransformComponent>())
+		{
+			EXPECT_NE(nullptr, transform);
+			++iterationsCount;
+		}
+		EXPECT_EQ(2, iterationsCount);
+	}
+
+	{
+		int iterationsCount = 0;
+		for (auto [empty, transform] : combinedEntityManager.view<EmptyComponent, TransformComponent>())
+		{
+			EXPECT_NE(nullptr, empty);
+			EXPECT_NE(nullptr, transform);
+			++iterationsCount;
+		}
+		EXPECT_EQ(1, iterationsCount);
+	}
+}
+
+TEST(CombinedEntityManagerView, ComponentSetsWithEntitiesCanBeIteratedOverWithView)
+{
+	using namespace TestCombinedEntityManagerView_Internal;
+
+	auto entityManagerData = PrepareEntityManager();
+	EntityManager& entityManager1 = entityManagerData->entityManager1;
+	EntityManager& entityManager2 = entityManagerData->entityManager2;
+	CombinedEntityManagerView& combinedEntityManager = entityManagerData->combinedEntityManager;
+
+	const Entity testEntity1 = entityManager1.addEntity();
+	const TransformComponent* transform1 = entityManager1.addComponent<TransformComponent>(testEntity1);
+	entityManager1.addComponent<MovementComponent>(testEntity1);
+
+	const Entity testEntity2 = entityManager2.addEntity();
+	entityManager2.addComponent<TransformComponent>(testEntity2);
+	entityManager2.addComponent<EmptyComponent>(testEntity2);
+
+	{
+		int iterationsCount = 0;
+		for (auto [entityView, movement] : combinedEntityManager.viewWithEntities<MovementComponent>())
+		{
+			EXPECT_EQ(testEntity1, entityView.getEntity());
+			EXPECT_NE(nullptr, movement);
+			++iterationsCount;
+		}
+		EXPECT_EQ(1, iterationsCount);
+	}
+
+	{
+		auto filteredView = combinedEntityManager.viewWithEntities<const TransformComponent>()
+			| std::views::filter([transform1](const auto& componentSet) { return std::get<1>(componentSet) == transform1; });
+
+		int iterationsCount = 0;
+		for (auto [entityView, transform] : filteredView)
+		{
+			EXPECT_EQ(testEntity1, entityView.getEntity());
+			++iterationsCount;
+		}
+		EXPECT_EQ(1, iterationsCount);
+	}
+}
+
+TEST(CombinedEntityManagerView, ComponentSetsWithAdditionalDataCanBeCollectedIntoArrays)
+{
+	using namespace TestCombinedEntityManagerView_Internal;
+
+	auto entityManagerData = PrepareEntityManager();
+	EntityManager& entityManager1 = entityManagerData->entityManager1;
+	EntityManager& entityManager2 = entityManagerData->entityManager2;
+	CombinedEntityManagerView& combinedEntityManager = entityManagerData->combinedEntityManager;
+
+	const Entity testEntity1 = entityManager1.addEntity();
+	entityManager1.addComponent<TransformComponent>(testEntity1);
+	entityManager1.addComponent<EmptyComponent>(testEntity1);
+
+	const Entity testEntity2 = entityManager2.addEntity();
+	entityManager2.addComponent<TransformComponent>(testEntity2);
+	entityManager2.addComponent<EmptyComponent>(testEntity2);
+
+	const Entity testEntity3 = entityManager2.addEntity();
+	entityManager2.addComponent<TransformComponent>(testEntity3);
+
+	{
+		RaccoonEcs::ComponentArraysWithExtraData<int, EmptyComponent, TransformComponent> arrays;
+		combinedEntityManager.getComponentArraysWithExtraData(arrays);
+		EXPECT_EQ(static_cast<size_t>(2u), arrays.size());
+
+		// the order of segments between entity managers is not specified, so they are matched by extra data
+		const auto& segments = arrays.getSegments();
+		ASSERT_EQ(static_cast<size_t>(2u), segments.size());
+		const bool isFirstSegmentFromManager1 = (segments[0].extraData == 20);
+		const auto& segment1 = isFirstSegmentFromManager1 ? segments[0] : segments[1];
+		const auto& segment2 = isFirstSegmentFromManager1 ? segments[1] : segments[0];
+		EXPECT_EQ(20, segment1.extraData);
+		EXPECT_EQ(static_cast<size_t>(1u), segment1.end - segment1.begin);
+		EXPECT_EQ(50, segment2.extraData);
+		EXPECT_EQ(static_cast<size_t>(1u), segment2.end - segment2.begin);
+	}
+
+	{
+		RaccoonEcs::ComponentArraysWithExtraData<int, TransformComponent> arrays;
+		combinedEntityManager.getComponentArraysWithEntitiesAndExtraData(arrays);
+		EXPECT_EQ(static_cast<size_t>(3u), arrays.size());
+		EXPECT_EQ(static_cast<size_t>(3u), arrays.getEntities().size());
+
+		const auto& segments = arrays.getSegments();
+		ASSERT_EQ(static_cast<size_t>(2u), segments.size());
+		const bool isFirstSegmentFromManager1 = (segments[0].extraData == 20);
+		const auto& segment1 = isFirstSegmentFromManager1 ? segments[0] : segments[1];
+		const auto& segment2 = isFirstSegmentFromManager1 ? segments[1] : segments[0];
+		EXPECT_EQ(20, segment1.extraData);
+		EXPECT_EQ(static_cast<size_t>(1u), segment1.end - segment1.begin);
+		EXPECT_EQ(50, segment2.extraData);
+		EXPECT_EQ(static_cast<size_t>(2u), segment2.end - segment2.begin);
+	}
+}
+
+TEST(CombinedEntityManagerView, ComponentSetsCanBeSearchedCountedAndReduced)
+{
+	using namespace TestCombinedEntityManagerView_Internal;
+
+	auto entityManagerData = PrepareEntityManager();
+	EntityManager& entityManager1 = entityManagerData->entityManager1;
+	EntityManager& entityManager2 = entityManagerData->entityManager2;
+	CombinedEntityManagerView& combinedEntityManager = entityManagerData->combinedEntityManager;
+
+	const Entity testEntity1 = entityManager1.addEntity();
+	entityManager1.addComponent<TransformComponent>(testEntity1)->pos = TestVector2(10, 0);
+	entityManager1.addComponent<MovementComponent>(testEntity1);
+
+	const Entity testEntity2 = entityManager2.addEntity();
+	entityManager2.addComponent<TransformComponent>(testEntity2)->pos = TestVector2(20, 0);
+	entityManager2.addComponent<EmptyComponent>(testEntity2);
+
+	{
+		const std::optional<EntityView> foundEntity = combinedEntityManager.findFirst<const TransformComponent>([](const TransformComponent* transform) {
+			return transform->pos.x == 20;
+		});
+		ASSERT_TRUE(foundEntity.has_value());
+		EXPECT_EQ(testEntity2, foundEntity->getEntity());
+	}
+
+	{
+		int predicateCallsCount = 0;
+		EXPECT_TRUE(combinedEntityManager.any<const TransformComponent>([&predicateCallsCount](const TransformComponent*) {
+			++predicateCallsCount;
+			return true;
+		}));
+		EXPECT_EQ(1, predicateCallsCount);
+	}
+
+	EXPECT_FALSE(combinedEntityManager.any<const EmptyComponent, const MovementComponent>([](const EmptyComponent*, const MovementComponent*) { return true; }));
+
+	EXPECT_EQ(static_cast<size_t>(2u), combinedEntityManager.countIf<const TransformComponent>([](const TransformComponent* transform) {
+		return transform->pos.x >= 10;
+	}));
+
+	const auto sumPositions = [](int sum, const TransformComponent* transform) {
+		return sum + transform->pos.x;
+	};
+	EXPECT_EQ(30, combinedEntityManager.reduce<const TransformComponent>(0, sumPositions));
+	// the initial value is counted once, not once per partition
+	EXPECT_EQ(130, combinedEntityManager.parallelReduce<const TransformComponent>(100, sumPositions, std::plus<int>(), 2));
+}
@@ -0,0 +1,854 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <optional>
+#include <span>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include "raccoon-ecs/entity_manager.h"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace TestComponentStoragePolicy_Internal
+{
+	enum ComponentType
+	{
+		TransformComponentId,
+		MovementComponentId,
+	};
+
+	using ComponentFactory = RaccoonEcs::ComponentFactoryImpl<ComponentType>;
+	using EntityManager = RaccoonEcs::EntityManagerImpl<ComponentType>;
+	using Entity = RaccoonEcs::Entity;
+	using ComponentStoragePolicy = RaccoonEcs::ComponentStoragePolicy;
+
+	struct TransformComponent
+	{
+		float x;
+		float y;
+		float z;
+
+		static ComponentType GetTypeId() { return TransformComponentId; };
+	};
+
+	struct MovementComponent
+	{
+		float dx;
+		float dy;
+
+		static ComponentType GetTypeId() { return MovementComponentId; };
+	};
+
+	template<typename T>
+	static bool isAligned(const T* pointer, size_t alignment)
+	{
+		return reinterpret_cast<std::uintptr_t>(pointer) % alignment == 0;
+	}
+
+	template<typename T>
+	static void addComponents(EntityManager& entityManager, int count)
+	{
+		for (int i = 0; i < count; ++i)
+		{
+			const Entity entity = entityManager.addEntity();
+			entityManager.addComponent<T>(entity);
+		}
+	}
+
+	// every thread writes to every threadsCount-th chunk, so neighboring chunks are written by different threads
+	static std::chrono::nanoseconds writeChunksInParallel(const std::vector<std::span<TransformComponent>>& chunks, size_t threadsCount, int iterationsCount)
+	{
+		std::vector<std::thread> threads;
+		const auto startTime = std::chrono::steady_clock::now();
+		for (size_t threadIndex = 0; threadIndex < threadsCount; ++threadIndex)
+		{
+			threads.emplace_back([&chunks, threadIndex, threadsCount, iterationsCount]() {
+				for (int iteration = 0; iteration < iterationsCount; ++iteration)
+				{
+					for (size_t chunkIndex = threadIndex; chunkIndex < chunks.size(); chunkIndex += threadsCount)
+					{
+						for (TransformComponent& transform : chunks[chunkIndex])
+						{
+							transform.x += 1.0f;
+						}
+					}
+					// keep the compiler from merging the writes of different iterations
+					std::atomic_signal_fence(std::memory_order_seq_cst);
+				}
+			});
+		}
+
+		for (std::thread& thread : threads)
+		{
+			thread.join();
+		}
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - startTime);
+	}
+
+	constexpr size_t HugePageSize = 2 * 1024 * 1024;
+
+	// 256 huge pages of TransformComponents (about 44.7M entities), together with the MovementComponents
+	// and the entity table the benchmark needs roughly 2 GB of free RAM per memory source
+	constexpr size_t BenchmarkHugePagesCount = 256;
+
+	class DtlbMissesCounter
+	{
+	public:
+		DtlbMissesCounter()
+		{
+#ifdef __linux__
+			perf_event_attr attributes{};
+			attributes.type = PERF_TYPE_HW_CACHE;
+			attributes.size = sizeof(attributes);
+			attributes.config = PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+			attributes.disabled = 1;
+			attributes.exclude_kernel = 1;
+			attributes.exclude_hv = 1;
+			mFileDescriptor = static_cast<int>(syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0));
+#endif
+		}
+
+		~DtlbMissesCounter()
+		{
+#ifdef __linux__
+			if (mFileDescriptor != -1)
+			{
+				close(mFileDescriptor);
+			}
+#endif
+		}
+
+		DtlbMissesCounter(const DtlbMissesCounter&) = delete;
+		DtlbMissesCounter& operator=(const DtlbMissesCounter&) = delete;
+
+		void start()
+		{
+#ifdef __linux__
+			if (mFileDescriptor != -1)
+			{
+				ioctl(mFileDescriptor, PERF_EVENT_IOC_RESET, 0);
+				ioctl(mFileDescriptor, PERF_EVENT_IOC_ENABLE, 0);
+			}
+#endif
+		}
+
+		// returns nothing if the counter is not supported or not permitted
+		std::optional<std::uint64_t> stop()
+		{
+#ifdef __linux__
+			if (mFileDescriptor != -1)
+			{
+				ioctl(mFileDescriptor, PERF_EVENT_IOC_DISABLE, 0);
+				std::uint64_t value = 0;
+				if (read(mFileDescriptor, &value, sizeof(value)) == static_cast<ssize_t>(sizeof(value)))
+				{
+					return value;
+				}
+			}
+#endif
+			return std::nullopt;
+		}
+
+	private:
+		[[maybe_unused]] int mFileDescriptor = -1;
+	};
+
+	static std::vector<std::span<TransformComponent>> collectChunks(EntityManager& entityManager)
+	{
+		std::vector<std::span<TransformComponent>> chunks;
+		entityManager.forEachComponentChunk<TransformComponent>([&chunks](std::span<TransformComponent> chunk) {
+			chunks.push_back(chunk);
+		});
+		return chunks;
+	}
+} // namespace EntityManagerTestInternals
+
+TEST(ComponentStoragePolicy, DefaultPolicy_ComponentsUseNaturalAlignment)
+{
+	using namespace TestComponentStoragePolicy_Internal;
+
+	ComponentFactory componentFactory;
+	componentFactory.registerComponent<TransformComponent>();
+	EntityManager entityManager(componentFactory);
+
+	addComponents<TransformComponent>(entityManager, 100);
+
+	entityManager.forEachComponentSet<TransformComponent>([](TransformComponent* transform) {
+		EXPECT_TRUE(isAligned(transform, alignof(TransformComponent)));
+	});
+}
+
+TEST(ComponentStoragePolicy, CustomAlignment_PoolBaseIsAligned)
+{
+	using namespace TestComponentStoragePolicy_Internal;
+
+	// alignment applies to the base of the pool (or of each chunk), elements are still laid out with sizeof(T) stride
+	ComponentStoragePolicy policy;
+	policy.alignment = 32;
+
+	ComponentFactory componentFactory;
+	componentFactory.registerComponent<TransformComponent>(policy);
+	componentFactory.registerComponent<MovementComponent>();
+	EntityManager entityManager(componentFactory);
+
+	// enough components to make the pool grow a few times
+	addComponents<TransformComponent>(entityManager, 1000);
+	addComponents<MovementComponent>(entityManager, 10);
+
+	// growing never moves components, so the pool can consist of several blocks, each of them aligned
+	size_t componentsCount = 0;
+	entityManager.forEachComponentChunk<TransformComponent>([&componentsCount](std::span<TransformComponent> chunk) {
+		EXPECT_FALSE(chunk.empty());
+		EXPECT_TRUE(isAligned(chunk.data(), 32));
+		componentsCount += chunk.size();
+	});
+	EXPECT_EQ(static_cast<size_t>(1000), componentsCount);
+
+	int iterationsCount = 0;
+	entityManager.forEachComponentSet<TransformComponent>([&iterationsCount](TransformComponent* transform) {
+		EXPECT_TRUE(isAligned(transform, alignof(TransformComponent)));
+		++iterationsCount;
+	});
+	EXPECT_EQ(1000, iterationsCount);
+}
+
+TEST(ComponentStoragePolicy, CacheLineChunks_IterateOverChunks_ChunksDoNotShareCacheLines)
+{
+	using namespace TestComponentStoragePolicy_Internal;
+
+	ComponentStoragePolicy policy;
+	policy.alignment = RaccoonEcs::CacheLineSize;
+	policy.chunkSize = 16;
+
+	ComponentFactory componentFactory;
+	componentFactory.registerComponent<TransformComponent>(policy);
+	EntityManager entityManager(componentFactory);
+
+	addComponents<TransformComponent>(entityManager, 100);
+
+	std::vector<std::span<TransformComponent>> chunks;
+	entityManager.forEachComponentChunk<TransformComponent>([&chunks](std::span<TransformComponent> chunk) {
+		chunks.push_back(chunk);
+	});
+
+	size_t componentsCount = 0;
+	for (const std::span<TransformComponent> chunk : chunks)
+	{
+		ASSERT_FALSE(chunk.empty());
+		EXPECT_LE(chunk.size(), policy.chunkSize);
+		EXPECT_TRUE(isAligned(chunk.data(), RaccoonEcs::CacheLineSize));
+		componentsCount += chunk.size();
+	}
+	EXPECT_EQ(static_cast<size_t>(100), componentsCount);
+
+	// the last byte of one chunk and the first byte of any other chunk are never on the same cache line
+	for (size_t i = 0; i < chunks.size(); ++i)
+	{
+		const auto lastByteLine = (reinterpret_cast<std::uintptr_t>(chunks[i].data() + chunks[i].size()) - 1) / RaccoonEcs::CacheLineSize;
+		for (size_t j = 0; j < chunks.size(); ++j)
+		{
+			if (i != j)
+			{
+				const auto firstByteLine = reinterpret_cast<std::uintptr_t>(chunks[j].data()) / RaccoonEcs::CacheLineSize;
+				EXPECT_NE(lastByteLine, firstByteLine);
+			}
+		}
+	}
+}
+
+TEST(ComponentStoragePolicy, CacheLineChunksWithCompaction_RemoveComponents_ChunksStayDenseAndAligned)
+{
+	using namespace TestComponentStoragePolicy_Internal;
+
+	// compaction is an opt-in that gives up the guarantee that components are never moved,
+	// with it chunks have no holes after removals
+	ComponentStoragePolicy policy;
+	policy.alignment = 64;
+	policy.chunkSize = 8;
+	policy.compactOnRemove = true;
+
+	ComponentFactory componentFactory;
+	componentFactory.registerComponent<TransformComponent>(policy);
+	EntityManager entityManager(componentFactory);
+
+	std::vector<Entity> entities;
+	for (int i = 0; i < 50; ++i)
+	{
+		const Entity entity = entityManager.addEntity();
+		entityManager.addComponent<TransformComponent>(entity)->x = static_cast<float>(i);
+		entities.push_back(entity);
+	}
+
+	for (size_t i = 0; i < entities.size(); i += 3)
+	{
+		entityManager.removeEntity(entities[i]);
+	}
+
+	std::vector<std::tuple<TransformComponent*>> components;
+	entityManager.getComponents<TransformComponent>(components);
+	EXPECT_EQ(static_cast<size_t>(33), components.size());
+
+	size_t componentsCount = 0;
+	entityManager.forEachComponentChunk<TransformComponent>([&componentsCount](std::span<TransformComponent> chunk) {
+		EXPECT_TRUE(isAligned(chunk.data(), 64));
+		EXPECT_LE(chunk.size(), static_cast<size_t>(8));
+		componentsCount += chunk.size();
+	});
+	EXPECT_EQ(static_cast<size_t>(33), componentsCount);
+}
+
+TEST(ComponentStoragePolicy, CacheLineChunks_RemoveComponents_RemainingComponentsAreNotMoved)
+{
+	using namespace TestComponentStoragePolicy_Internal;
+
+	ComponentStoragePolicy policy;
+	policy.alignment = 64;
+	policy.chunkSize = 8;
+
+	ComponentFactory componentFactory;
+	componentFactory.registerComponent<TransformComponent>(policy);
+	EntityManager entityManager(componentFactory);
+
+	std::vector<Entity> entities;
+	std::vector<TransformComponent*> transforms;
+	for (int i = 0; i < 50; ++i)
+	{
+		const Entity entity = entityManager.addEntity();
+		TransformComponent* transform = entityManager.addComponent<TransformComponent>(entity);
+		transform->x = static_cast<float>(i);
+		entities.push_back(entity);
+		transforms.push_back(transform);
+	}
+
+	for (size_t i = 0; i < entities.size(); i += 3)
+	{
+		entityManager.removeEntity(entities[i]);
+	}
+
+	// without compaction the chunked pool keeps the default guarantee that components are never moved
+	for (size_t i = 0; i < entities.size(); ++i)
+	{
+		if (i % 3 != 0)
+		{
+			auto [transform] = entityManager.getEntityComponents<TransformComponent>(entities[i]);
+			EXPECT_EQ(transforms[i], transform);
+			EXPECT_EQ(static_cast<float>(i), transform->x);
+		}
+	}
+}
+
+TEST(ComponentStoragePolicy, CacheLineChunks_WriteChunksFromMultipleThreads_AllComponentsAreUpdated)
+{
+	using namespace TestComponentStoragePolicy_Internal;
+
+	ComponentStoragePolicy policy;
+	policy.alignment = RaccoonEcs::CacheLineSize;
+	policy.chunkSize = 4;
+
+	ComponentFactory componentFactory;
+	componentFactory.registerComponent<TransformComponent>(policy);
+	EntityManager entityManager(componentFactory);
+
+	for (int i = 0; i < 256; ++i)
+	{
+		const Entity entity = entityManager.addEntity();
+		entityManager.addComponent<TransformComponent>(entity)->x = 0.0f;
+	}
+
+	writeChunksInParallel(collectChunks(entityManager), 4, 10);
+
+	entityManager.forEachComponentSet<TransformComponent>([](TransformComponent* transform) {
+		EXPECT_EQ(10.0f, transform->x);
+	});
+}
+
+// benchmark, run with --gtest_also_run_disabled_tests
+// compares parallel writes to chunks that share cache lines with writes to cache-line padded chunks
+TEST(ComponentStoragePolicy, DISABLED_Benchmark_FalseSharingWithAndWithoutChunkPadding)
+{
+	using namespace TestComponentStoragePolicy_Internal;
+
+	constexpr size_t componentsPerChunk = 4;
+	constexpr int componentsCount = 4096;
+	constexpr int iterationsCount = 20000;
+	const size_t threadsCount = std::max(2u, std::thread::hardware_concurrency());
+
+	// packed pool split into chunks of four 12-byte components, so most chunks share a cache line with a neighbor
+	ComponentFactory packedComponentFactory;
+	packedComponentFactory.registerComponent<TransformComponent>();
+	EntityManager packedEntityManager(packedComponentFactory);
+	addComponents<TransformComponent>(packedEntityManager, componentsCount);
+
+	std::vector<std::span<TransformComponent>> packedChunks;
+	for (const std::span<TransformComponent> pool : collectChunks(packedEntityManager))
+	{
+		for (size_t offset = 0; offset < pool.size(); offset += componentsPerChunk)
+		{
+			packedChunks.push_back(pool.subspan(offset, std::min(componentsPerChunk, pool.size() - offset)));
+		}
+	}
+
+	ComponentStoragePolicy policy;
+	policy.alignment = RaccoonEcs::CacheLineSize;
+	policy.chunkSize = componentsPerChunk;
+
+	ComponentFactory paddedComponentFactory;
+	paddedComponentFactory.registerComponent<TransformComponent>(policy);
+	EntityManager paddedEntityManager(paddedComponentFactory);
+	addComponents<TransformComponent>(paddedEntityManager, componentsCount);
+	const std::vector<std::span<TransformComponent>> paddedChunks = collectChunks(paddedEntityManager);
+
+	const std::chrono::nanoseconds packedTime = writeChunksInParallel(packedChunks, threadsCount, iterationsCount);
+	const std::chrono::nanoseconds paddedTime = writeChunksInParallel(paddedChunks, threadsCount, iterationsCount);
+
+	std::cout << "threads: " << threadsCount
+		<< ", packed chunks: " << std::chrono::duration_cast<std::chrono::milliseconds>(packedTime).count() << " ms"
+		<< ", cache-line padded chunks: " << std::chrono::duration_cast<std::chrono::milliseconds>(paddedTime).count() << " ms"
+		<< std::endl;
+	RecordProperty("PackedChunksNs", std::to_string(packedTime.count()));
+	RecordProperty("PaddedChunksNs", std::to_string(paddedTime.count()));
+}
+
+TEST(ComponentStoragePolicy, InitialCapacity_AddComponentsUpToCapacity_PoolDoesNotGrow)
+{
+	using namespace TestComponentStoragePolicy_Internal;
+
+	ComponentStoragePolicy policy;
+	policy.initialCapacity = 100;
+
+	ComponentFactory componentFactory;
+	componentFactory.registerComponent<TransformComponent>(policy);
+	EntityManager entityManager(componentFactory);
+
+	EXPECT_EQ(static_cast<size_t>(100), entityManager.getComponentPoolCapacity<TransformComponent>());
+
+	addComponents<TransformComponent>(entityManager, 100);
+	EXPECT_EQ(static_cast<size_t>(100), entityManager.getComponentPoolCapacity<TransformComponent>());
+}
+
+TEST(ComponentStoragePolicy, GrowthFactor_PoolIsFull_CapacityIsMultipliedByGrowthFactor)
+{
+	using namespace TestComponentStoragePolicy_Internal;
+
+	ComponentStoragePolicy policy;
+	policy.initialCapacity = 4;
+	policy.growthFactor = 2.0f;
+
+	ComponentFactory componentFactory;
+	componentFactory.registerComponent<TransformComponent>(policy);
+	EntityManager entityManager(componentFactory);
+
+	addComponents<TransformComponent>(entityManager, 5);
+	EXPECT_EQ(static_cast<size_t>(8), entityManager.getComponentPoolCapacity<TransformComponent>());
+
+	addComponents<TransformComponent>(entityManager, 4);
+	EXPECT_EQ(static_cast<size_t>(16), entityManager.getComponentPoolCapacity<TransformComponent>());
+}
+
+TEST(ComponentStoragePolicy, DefaultPolicy_PoolGrows_ComponentsAreNotRelocated)
+{
+	using namespace TestComponentStoragePolicy_Internal;
+
+	EXPECT_EQ(RaccoonEcs::ComponentStorageLayout::Stable, ComponentStoragePolicy{}.layout);
+
+	ComponentFactory componentFactory;
+	componentFactory.registerComponent<TransformComponent>(ComponentStoragePolicy{});
+	EntityManager entityManager(componentFactory);
+
+	const Entity firstEntity = entityManager.addEntity();
+	TransformComponent* firstTransform = entityManager.addComponent<TransformComponent>(firstEntity);
+	firstTransform->x = 42.0f;
+
+	addComponents<TransformComponent>(entityManager, 1000);
+
+	// the default layout is the same stable storage as without a policy, growing adds memory without moving anything
+	auto [transform] = entityManager.getEntityComponents<TransformComponent>(firstEntity);
+	EXPECT_EQ(firstTransform, transform);
+	EXPECT_EQ(42.0f, transform->x);
+	EXPECT_GE(entityManager.getComponentPoolCapacity<TransformComponent>(), static_cast<size_t>(1001));
+}
+
+TEST(ComponentStoragePolicy, ContiguousLayout_PoolGrows_AllComponentsAreInOneBlock)
+{
+	using namespace TestComponentStoragePolicy_Internal;
+
+	// Contiguous is an opt-in that keeps the whole pool in one block and relocates it on growth,
+	// so pointers to its components are invalidated by adding components
+	ComponentStoragePolicy policy;
+	policy.layout = RaccoonEcs::ComponentStorageLayout::Contiguous;
+
+	ComponentFactory componentFactory;
+	componentFactory.registerComponent<TransformComponent>(policy);
+	EntityManager entityManager(componentFactory);
+
+	const Entity firstEntity = entityManager.addEntity();
+	entityManager.addComponent<TransformComponent>(firstEntity)->x = 42.0f;
+
+	addComponents<TransformComponent>(entityManager, 1000);
+
+	size_t chunksCount = 0;
+	entityManager.forEachComponentChunk<TransformComponent>([&chunksCount](std::span<TransformComponent> chunk) {
+		EXPECT_EQ(static_cast<size_t>(1001), chunk.size());
+		++chunksCount;
+	});
+	EXPECT_EQ(static_cast<size_t>(1), chunksCount);
+
+	auto [transform] = entityManager.getEntityComponents<TransformComponent>(firstEntity);
+	ASSERT_NE(nullptr, transform);
+	EXPECT_EQ(42.0f, transform->x);
+}
+
+TEST(ComponentStoragePolicy, PagedLayout_PoolGrows_ComponentsAreNotRelocated)
+{
+	using namespace TestComponentStoragePolicy_Internal;
+
+	ComponentStoragePolicy policy;
+	policy.layout = RaccoonEcs::ComponentStorageLayout::Paged;
+	policy.chunkSize = 32;
+
+	ComponentFactory componentFactory;
+	componentFactory.registerComponent<TransformComponent>(policy);
+	EntityManager entityManager(componentFactory);
+
+	const Entity firstEntity = entityManager.addEntity();
+	TransformComponent* firstTransform = entityManager.addComponent<TransformComponent>(firstEntity);
+	firstTransform->x = 42.0f;
+
+	addComponents<TransformComponent>(entityManager, 1000);
+
+	// paged pools grow by adding pages of chunkSize elements, the existing elements stay where they were
+	auto [transform] = entityManager.getEntityComponents<TransformComponent>(firstEntity);
+	EXPECT_EQ(firstTransform, transform);
+	EXPECT_EQ(42.0f, transform->x);
+	EXPECT_EQ(static_cast<size_t>(0), entityManager.getComponentPoolCapacity<TransformComponent>() % policy.chunkSize);
+	EXPECT_GE(entityManager.getComponentPoolCapacity<TransformComponent>(), static_cast<size_t>(1001));
+}
+
+TEST(ComponentStoragePolicy, ShrinkHysteresis_RemoveComponents_PoolShrinksOnlyBelowThreshold)
+{
+	using namespace TestComponentStoragePolicy_Internal;
+
+	// releasing memory of a partly filled pool means moving its components, so shrinking needs the relocating layout
+	ComponentStoragePolicy policy;
+	policy.layout = RaccoonEcs::ComponentStorageLayout::Contiguous;
+	policy.initialCapacity = 64;
+	policy.shrinkHysteresis = 0.25f;
+
+	ComponentFactory componentFactory;
+	componentFactory.registerComponent<TransformComponent>(policy);
+	EntityManager entityManager(componentFactory);
+
+	std::vector<Entity> entities;
+	for (int i = 0; i < 64; ++i)
+	{
+		const Entity entity = entityManager.addEntity();
+		entityManager.addComponent<TransformComponent>(entity);
+		entities.push_back(entity);
+	}
+	EXPECT_EQ(static_cast<size_t>(64), entityManager.getComponentPoolCapacity<TransformComponent>());
+
+	// 16 components left is exactly at the threshold, the pool keeps its memory
+	while (entities.size() > 16)
+	{
+		entityManager.removeEntity(entities.back());
+		entities.pop_back();
+	}
+	EXPECT_EQ(static_cast<size_t>(64), entityManager.getComponentPoolCapacity<TransformComponent>());
+
+	entityManager.removeEntity(entities.back());
+	entities.pop_back();
+	EXPECT_LT(entityManager.getComponentPoolCapacity<TransformComponent>(), static_cast<size_t>(64));
+	EXPECT_GE(entityManager.getComponentPoolCapacity<TransformComponent>(), static_cast<size_t>(15));
+}
+
+TEST(ComponentStoragePolicy, DefaultPolicy_RemoveComponents_PoolDoesNotShrink)
+{
+	using namespace TestComponentStoragePolicy_Internal;
+
+	ComponentFactory componentFactory;
+	componentFactory.registerComponent<TransformComponent>();
+	EntityManager entityManager(componentFactory);
+
+	std::vector<Entity> entities;
+	for (int i = 0; i < 200; ++i)
+	{
+		const Entity entity = entityManager.addEntity();
+		entityManager.addComponent<TransformComponent>(entity);
+		entities.push_back(entity);
+	}
+	const size_t capacity = entityManager.getComponentPoolCapacity<TransformComponent>();
+
+	for (const Entity entity : entities)
+	{
+		entityManager.removeEntity(entity);
+	}
+	EXPECT_EQ(capacity, entityManager.getComponentPoolCapacity<TransformComponent>());
+}
+
+// benchmark, run with --gtest_also_run_disabled_tests
+// runs the same spawn waves under each storage policy and reports the reserved memory and the time spent
+TEST(ComponentStoragePolicy, DISABLED_Benchmark_SpawnWavesWithDifferentStoragePolicies)
+{
+	using namespace TestComponentStoragePolicy_Internal;
+
+	constexpr int wavesCount = 20;
+	constexpr int spawnedPerWave = 100000;
+	// most of the wave dies before the next one spawns, so the live count goes up and down
+	constexpr int survivorsPerWave = 2000;
+
+	struct NamedPolicy
+	{
+		std::string name;
+		ComponentStoragePolicy policy;
+	};
+
+	std::vector<NamedPolicy> policies;
+	policies.push_back({"default stable layout", ComponentStoragePolicy{}});
+	{
+		ComponentStoragePolicy policy;
+		policy.layout = RaccoonEcs::ComponentStorageLayout::Paged;
+		policy.chunkSize = 1024;
+		policies.push_back({"paged, 1024 per page", policy});
+	}
+	{
+		ComponentStoragePolicy policy;
+		policy.layout = RaccoonEcs::ComponentStorageLayout::Contiguous;
+		policies.push_back({"contiguous (relocating), default growth", policy});
+	}
+	{
+		ComponentStoragePolicy policy;
+		policy.layout = RaccoonEcs::ComponentStorageLayout::Contiguous;
+		policy.growthFactor = 1.5f;
+		policies.push_back({"contiguous (relocating), growth factor 1.5", policy});
+	}
+	{
+		ComponentStoragePolicy policy;
+		policy.layout = RaccoonEcs::ComponentStorageLayout::Contiguous;
+		policy.growthFactor = 2.0f;
+		policies.push_back({"contiguous (relocating), growth factor 2.0", policy});
+	}
+	{
+		ComponentStoragePolicy policy;
+		policy.layout = RaccoonEcs::ComponentStorageLayout::Contiguous;
+		policy.growthFactor = 2.0f;
+		policy.shrinkHysteresis = 0.25f;
+		policies.push_back({"contiguous (relocating), growth factor 2.0, shrink below 25%", policy});
+	}
+
+	for (const NamedPolicy& namedPolicy : policies)
+	{
+		ComponentFactory componentFactory;
+		componentFactory.registerComponent<TransformComponent>(namedPolicy.policy);
+		EntityManager entityManager(componentFactory);
+
+		std::vector<Entity> wave;
+		wave.reserve(spawnedPerWave);
+		size_t peakCapacity = 0;
+
+		const auto startTime = std::chrono::steady_clock::now();
+		for (int waveIndex = 0; waveIndex < wavesCount; ++waveIndex)
+		{
+			wave.clear();
+			for (int i = 0; i < spawnedPerWave; ++i)
+			{
+				const Entity entity = entityManager.addEntity();
+				entityManager.addComponent<TransformComponent>(entity)->x = static_cast<float>(i);
+				wave.push_back(entity);
+			}
+			peakCapacity = std::max(peakCapacity, entityManager.getComponentPoolCapacity<TransformComponent>());
+
+			for (size_t i = survivorsPerWave; i < wave.size(); ++i)
+			{
+				entityManager.removeEntity(wave[i]);
+			}
+		}
+		const auto elapsedTime = std::chrono::steady_clock::now() - startTime;
+
+		const size_t finalCapacity = entityManager.getComponentPoolCapacity<TransformComponent>();
+		std::cout << namedPolicy.name
+			<< ": " << std::chrono::duration_cast<std::chrono::milliseconds>(elapsedTime).count() << " ms"
+			<< ", peak capacity: " << peakCapacity << " (" << peakCapacity * sizeof(TransformComponent) << " bytes)"
+			<< ", capacity after the last wave: " << finalCapacity << " (" << finalCapacity * sizeof(TransformComponent) << " bytes)"
+			<< std::endl;
+	}
+}
+
+TEST(ComponentStoragePolicy, HugePages_AddComponents_DataIsIntact)
+{
+	using namespace TestComponentStoragePolicy_Internal;
+
+	ComponentStoragePolicy policy;
+	policy.memorySource = RaccoonEcs::MemorySource::HugePages;
+
+	ComponentFactory componentFactory;
+	componentFactory.registerComponent<TransformComponent>(policy);
+	componentFactory.registerComponent<MovementComponent>();
+
+	RaccoonEcs::EntityManagerOptions options;
+	options.entityTableMemorySource = RaccoonEcs::MemorySource::HugePages;
+	EntityManager entityManager(componentFactory, options);
+
+	// several 2 MB huge pages worth of components and entity records
+	const int entitiesCount = static_cast<int>(3 * HugePageSize / sizeof(TransformComponent));
+	std::vector<Entity> entities;
+	entities.reserve(static_cast<size_t>(entitiesCount));
+	for (int i = 0; i < entitiesCount; ++i)
+	{
+		const Entity entity = entityManager.addEntity();
+		entityManager.addComponent<TransformComponent>(entity)->x = static_cast<float>(i);
+		entities.push_back(entity);
+	}
+
+	// whether huge pages can actually be obtained depends on the machine (the forced fallback is tested separately),
+	// but a pool registered without huge pages never uses them
+	EXPECT_EQ(RaccoonEcs::MemorySource::Default, entityManager.getComponentPoolMemorySource<MovementComponent>());
+
+	for (int i = 0; i < entitiesCount; i += 9973)
+	{
+		auto [transform] = entityManager.getEntityComponents<TransformComponent>(entities[i]);
+		ASSERT_NE(nullptr, transform);
+		EXPECT_EQ(static_cast<float>(i), transform->x);
+	}
+	EXPECT_EQ(static_cast<size_t>(entitiesCount), entityManager.getMatchingEntitiesCount<TransformComponent>());
+}
+
+TEST(ComponentStoragePolicy, HugePages_HugePageMappingFails_RegularPagesAreUsed)
+{
+	using namespace TestComponentStoragePolicy_Internal;
+
+	ComponentStoragePolicy policy;
+	policy.memorySource = RaccoonEcs::MemorySource::HugePages;
+
+	ComponentFactory componentFactory;
+	componentFactory.registerComponent<TransformComponent>(policy);
+
+	// makes every huge page mapping of this manager fail, as on a machine without free huge pages
+	RaccoonEcs::EntityManagerOptions options;
+	options.entityTableMemorySource = RaccoonEcs::MemorySource::HugePages;
+	options.forceHugePagesFailureForTesting = true;
+	EntityManager entityManager(componentFactory, options);
+
+	std::vector<Entity> entities;
+	for (int i = 0; i < 1000; ++i)
+	{
+		const Entity entity = entityManager.addEntity();
+		entityManager.addComponent<TransformComponent>(entity)->x = static_cast<float>(i);
+		entities.push_back(entity);
+	}
+
+	EXPECT_EQ(RaccoonEcs::MemorySource::Default, entityManager.getComponentPoolMemorySource<TransformComponent>());
+	EXPECT_EQ(RaccoonEcs::MemorySource::Default, entityManager.getEntityTableMemorySource());
+	for (int i = 0; i < 1000; ++i)
+	{
+		auto [transform] = entityManager.getEntityComponents<TransformComponent>(entities[i]);
+		ASSERT_NE(nullptr, transform);
+		EXPECT_EQ(static_cast<float>(i), transform->x);
+	}
+}
+
+TEST(ComponentStoragePolicy, HugePages_DefaultOptions_RegularPagesAreUsed)
+{
+	using namespace TestComponentStoragePolicy_Internal;
+
+	ComponentFactory componentFactory;
+	componentFactory.registerComponent<TransformComponent>();
+	EntityManager entityManager(componentFactory);
+
+	addComponents<TransformComponent>(entityManager, 100);
+
+	EXPECT_EQ(RaccoonEcs::MemorySource::Default, entityManager.getComponentPoolMemorySource<TransformComponent>());
+	EXPECT_EQ(RaccoonEcs::MemorySource::Default, entityManager.getEntityTableMemorySource());
+}
+
+TEST(ComponentStoragePolicy, HugePages_CloneIntoRegularManager_ComponentsAreCopied)
+{
+	using namespace TestComponentStoragePolicy_Internal;
+
+	ComponentStoragePolicy policy;
+	policy.memorySource = RaccoonEcs::MemorySource::HugePages;
+
+	ComponentFactory componentFactory;
+	componentFactory.registerComponent<TransformComponent>(policy);
+
+	RaccoonEcs::EntityManagerOptions options;
+	options.entityTableMemorySource = RaccoonEcs::MemorySource::HugePages;
+	EntityManager entityManager(componentFactory, options);
+
+	const Entity entity = entityManager.addEntity();
+	entityManager.addComponent<TransformComponent>(entity)->y = 3.0f;
+
+	// the entity table memory source is a property of the destination, so the copy keeps regular pages for it
+	EntityManager entityManagerCopy(componentFactory);
+	entityManagerCopy.overrideBy(entityManager);
+
+	EXPECT_EQ(RaccoonEcs::MemorySource::Default, entityManagerCopy.getEntityTableMemorySource());
+	auto [transform] = entityManagerCopy.getEntityComponents<TransformComponent>(entity);
+	ASSERT_NE(nullptr, transform);
+	EXPECT_EQ(3.0f, transform->y);
+}
+
+// benchmark, run with --gtest_also_run_disabled_tests
+// reports iteration throughput and dTLB load misses (where perf_event_open is permitted) with and without huge pages
+TEST(ComponentStoragePolicy, DISABLED_Benchmark_IterationWithAndWithoutHugePages)
+{
+	using namespace TestComponentStoragePolicy_Internal;
+
+	const int entitiesCount = static_cast<int>(BenchmarkHugePagesCount * HugePageSize / sizeof(TransformComponent));
+	constexpr int passesCount = 20;
+
+	for (const RaccoonEcs::MemorySource memorySource : {RaccoonEcs::MemorySource::Default, RaccoonEcs::MemorySource::HugePages})
+	{
+		ComponentStoragePolicy policy;
+		policy.memorySource = memorySource;
+
+		ComponentFactory componentFactory;
+		componentFactory.registerComponent<TransformComponent>(policy);
+		componentFactory.registerComponent<MovementComponent>(policy);
+
+		RaccoonEcs::EntityManagerOptions options;
+		options.entityTableMemorySource = memorySource;
+		EntityManager entityManager(componentFactory, options);
+
+		// spread the entities so iteration has to look up both pools through the entity table
+		for (int i = 0; i < entitiesCount; ++i)
+		{
+			const Entity entity = entityManager.addEntity();
+			entityManager.addComponent<TransformComponent>(entity);
+			if (i % 3 != 0)
+			{
+				entityManager.addComponent<MovementComponent>(entity)->dx = 1.0f;
+			}
+		}
+
+		DtlbMissesCounter dtlbMissesCounter;
+		const auto startTime = std::chrono::steady_clock::now();
+		dtlbMissesCounter.start();
+		for (int pass = 0; pass < passesCount; ++pass)
+		{
+			entityManager.forEachComponentSet<TransformComponent, MovementComponent>([](TransformComponent* transform, MovementComponent* movement) {
+				transform->x += movement->dx;
+			});
+		}
+		const std::optional<std::uint64_t> dtlbMisses = dtlbMissesCounter.stop();
+		const auto elapsedTime = std::chrono::steady_clock::now() - startTime;
+
+		const double seconds = std::chrono::duration<double>(elapsedTime).count();
+		const std::string sourceName = (entityManager.getComponentPoolMemorySource<TransformComponent>() == RaccoonEcs::MemorySource::HugePages) ? "huge pages" : "regular pages";
+		std::cout << sourceName
+			<< ": " << static_cast<double>(entitiesCount) * passesCount / seconds / 1.0e6 << " M entities/s"
+			<< ", dTLB load misses: " << (dtlbMisses ? std::to_string(*dtlbMisses) : std::string("unavailable"))
+			<< std::endl;
+	}
+}
@@ -2,6 +2,8 @@
 
 #include "raccoon-ecs/delegates.h"
 
+#include "tests/utils/allocation_counter.h"
+
 
 TEST(SinglecastDelegate, NotAssigned_CallSafe_ExpectNothingHappened)
 {
@@ -75,3 +77,21 @@ TEST(MulticastDelegate, TwoFunctionsBound_Broadcast_ExpectAllCalled)
 
 	EXPECT_EQ(value, 9);
 }
+
+TEST(MulticastDelegate, Reserved_BindWithinCapacity_NothingIsAllocated)
+{
+	RaccoonEcs::MulticastDelegate<int> delegate;
+	delegate.reserve(4);
+
+	int sum = 0;
+	AllocationCounter::ScopedAllocationCounter counter;
+
+	for (int i = 0; i < 4; ++i)
+	{
+		delegate.bind([&sum](int value) { sum += value; });
+	}
+	delegate.broadcast(2);
+
+	EXPECT_EQ(static_cast<size_t>(0), counter.getAllocationsCount());
+	EXPECT_EQ(8, sum);
+}
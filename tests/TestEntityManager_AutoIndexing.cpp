@@ -0,0 +1,237 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "raccoon-ecs/entity_manager.h"
+
+namespace TestEntityManager_AutoIndexing_Internal
+{
+	enum ComponentType
+	{
+		ComponentTypeA,
+		ComponentTypeB,
+		ComponentTypeC,
+	};
+
+	using ComponentFactory = RaccoonEcs::ComponentFactoryImpl<ComponentType>;
+	using EntityManager = RaccoonEcs::EntityManagerImpl<ComponentType>;
+	using Entity = RaccoonEcs::Entity;
+
+	struct ComponentA
+	{
+		int value;
+
+		static ComponentType GetTypeId() { return ComponentTypeA; };
+	};
+
+	struct ComponentB
+	{
+		int value;
+
+		static ComponentType GetTypeId() { return ComponentTypeB; };
+	};
+
+	struct ComponentC
+	{
+		int value;
+
+		static ComponentType GetTypeId() { return ComponentTypeC; };
+	};
+
+	struct EntityManagerData
+	{
+		ComponentFactory componentFactory;
+		EntityManager entityManager{componentFactory};
+	};
+
+	static void RegisterComponents(ComponentFactory& inOutFactory)
+	{
+		inOutFactory.registerComponent<ComponentA>();
+		inOutFactory.registerComponent<ComponentB>();
+		inOutFactory.registerComponent<ComponentC>();
+	}
+
+	static std::unique_ptr<EntityManagerData> PrepareEntityManager()
+	{
+		auto data = std::make_unique<EntityManagerData>();
+		RegisterComponents(data->componentFactory);
+		return data;
+	}
+
+	static EntityManager::AutoIndexingPolicy MakeTestPolicy()
+	{
+		EntityManager::AutoIndexingPolicy policy;
+		policy.createIndexAfterQueriesCount = 3;
+		policy.dropIndexAfterIdleUpdatesCount = 2;
+		return policy;
+	}
+
+	static void fillEntities(EntityManager& entityManager)
+	{
+		for (int i = 0; i < 10; ++i)
+		{
+			const Entity entity = entityManager.addEntity();
+			entityManager.addComponent<ComponentA>(entity)->value = i;
+			if (i % 2 == 0)
+			{
+				entityManager.addComponent<ComponentB>(entity)->value = i * 10;
+			}
+		}
+	}
+
+	static int countAB(EntityManager& entityManager)
+	{
+		int count = 0;
+		entityManager.forEachComponentSet<const ComponentA, const ComponentB>([&count](const ComponentA*, const ComponentB*) {
+			++count;
+		});
+		return count;
+	}
+} // namespace EntityManagerTestInternals
+
+TEST(EntityManager, EntityManagerWithoutAutoIndexing_RunQueries_NoStatisticsCollectedAndNoIndexesCreated)
+{
+	using namespace TestEntityManager_AutoIndexing_Internal;
+
+	auto entityManagerData = PrepareEntityManager();
+	EntityManager& entityManager = entityManagerData->entityManager;
+	fillEntities(entityManager);
+
+	for (int i = 0; i < 10; ++i)
+	{
+		countAB(entityManager);
+	}
+	entityManager.updateAutoIndexes();
+
+	EXPECT_TRUE(entityManager.getQueryStatistics().empty());
+	EXPECT_TRUE(entityManager.getAutoIndexingDecisions().empty());
+	EXPECT_FALSE((entityManager.hasIndex<ComponentA, ComponentB>()));
+}
+
+TEST(EntityManager, EntityManagerWithAutoIndexing_RunQueries_QueryStatisticsAreCollected)
+{
+	using namespace TestEntityManager_AutoIndexing_Internal;
+
+	auto entityManagerData = PrepareEntityManager();
+	EntityManager& entityManager = entityManagerData->entityManager;
+	fillEntities(entityManager);
+	entityManager.enableAutoIndexing(MakeTestPolicy());
+
+	countAB(entityManager);
+	countAB(entityManager);
+	entityManager.forEachComponentSet<const ComponentA>([](const ComponentA*) {});
+
+	const std::vector<EntityManager::QueryStatistics>& statistics = entityManager.getQueryStatistics();
+	ASSERT_EQ(static_cast<size_t>(2), statistics.size());
+
+	const auto abStatisticsIt = std::find_if(statistics.begin(), statistics.end(), [](const EntityManager::QueryStatistics& queryStatistics) {
+		return queryStatistics.componentTypes == std::vector<ComponentType>{ComponentTypeA, ComponentTypeB};
+	});
+	ASSERT_NE(statistics.end(), abStatisticsIt);
+	EXPECT_EQ(static_cast<size_t>(2), abStatisticsIt->queriesCount);
+	EXPECT_EQ(static_cast<size_t>(10), abStatisticsIt->matchedEntitiesCount);
+	// without an index each query has to check at least every entity from the smallest pool
+	EXPECT_GE(abStatisticsIt->checkedEntitiesCount, static_cast<size_t>(10));
+}
+
+TEST(EntityManager, EntityManagerWithAutoIndexing_QueryFrequently_IndexIsCreated)
+{
+	using namespace TestEntityManager_AutoIndexing_Internal;
+
+	auto entityManagerData = PrepareEntityManager();
+	EntityManager& entityManager = entityManagerData->entityManager;
+	fillEntities(entityManager);
+	entityManager.enableAutoIndexing(MakeTestPolicy());
+
+	countAB(entityManager);
+	countAB(entityManager);
+	entityManager.updateAutoIndexes();
+	EXPECT_FALSE((entityManager.hasIndex<ComponentA, ComponentB>()));
+
+	countAB(entityManager);
+	entityManager.updateAutoIndexes();
+	EXPECT_TRUE((entityManager.hasIndex<ComponentA, ComponentB>()));
+
+	const std::vector<EntityManager::AutoIndexingDecision>& decisions = entityManager.getAutoIndexingDecisions();
+	ASSERT_EQ(static_cast<size_t>(1), decisions.size());
+	EXPECT_EQ(EntityManager::AutoIndexingAction::CreateIndex, decisions[0].action);
+	EXPECT_EQ((std::vector<ComponentType>{ComponentTypeA, ComponentTypeB}), decisions[0].componentTypes);
+
+	// the index is kept up to date after being created
+	EXPECT_EQ(5, countAB(entityManager));
+	const Entity entity = entityManager.addEntity();
+	entityManager.addComponent<ComponentA>(entity);
+	entityManager.addComponent<ComponentB>(entity);
+	EXPECT_EQ(6, countAB(entityManager));
+}
+
+TEST(EntityManager, EntityManagerWithAutoIndexing_StopQuerying_IndexIsDropped)
+{
+	using namespace TestEntityManager_AutoIndexing_Internal;
+
+	auto entityManagerData = PrepareEntityManager();
+	EntityManager& entityManager = entityManagerData->entityManager;
+	fillEntities(entityManager);
+	entityManager.enableAutoIndexing(MakeTestPolicy());
+
+	for (int i = 0; i < 3; ++i)
+	{
+		countAB(entityManager);
+	}
+	entityManager.updateAutoIndexes();
+	ASSERT_TRUE((entityManager.hasIndex<ComponentA, ComponentB>()));
+
+	entityManager.updateAutoIndexes();
+	EXPECT_TRUE((entityManager.hasIndex<ComponentA, ComponentB>()));
+	entityManager.updateAutoIndexes();
+	EXPECT_FALSE((entityManager.hasIndex<ComponentA, ComponentB>()));
+
+	const std::vector<EntityManager::AutoIndexingDecision>& decisions = entityManager.getAutoIndexingDecisions();
+	ASSERT_EQ(static_cast<size_t>(2), decisions.size());
+	EXPECT_EQ(EntityManager::AutoIndexingAction::DropIndex, decisions[1].action);
+	EXPECT_EQ((std::vector<ComponentType>{ComponentTypeA, ComponentTypeB}), decisions[1].componentTypes);
+
+	EXPECT_EQ(5, countAB(entityManager));
+}
+
+TEST(EntityManager, EntityManagerWithAutoIndexing_ManualIndexNotQueried_IndexIsNotDropped)
+{
+	using namespace TestEntityManager_AutoIndexing_Internal;
+
+	auto entityManagerData = PrepareEntityManager();
+	EntityManager& entityManager = entityManagerData->entityManager;
+	fillEntities(entityManager);
+	entityManager.initIndex<ComponentC>();
+	entityManager.enableAutoIndexing(MakeTestPolicy());
+
+	for (int i = 0; i < 5; ++i)
+	{
+		entityManager.updateAutoIndexes();
+	}
+
+	EXPECT_TRUE(entityManager.hasIndex<ComponentC>());
+	EXPECT_TRUE(entityManager.getAutoIndexingDecisions().empty());
+}
+
+TEST(EntityManager, EntityManagerWithAutoIndexing_ClearDecisions_DecisionsAreEmpty)
+{
+	using namespace TestEntityManager_AutoIndexing_Internal;
+
+	auto entityManagerData = PrepareEntityManager();
+	EntityManager& entityManager = entityManagerData->entityManager;
+	fillEntities(entityManager);
+	entityManager.enableAutoIndexing(MakeTestPolicy());
+
+	for (int i = 0; i < 3; ++i)
+	{
+		countAB(entityManager);
+	}
+	entityManager.updateAutoIndexes();
+	ASSERT_FALSE(entityManager.getAutoIndexingDecisions().empty());
+
+	entityManager.clearAutoIndexingDecisions();
+
+	EXPECT_TRUE(entityManager.getAutoIndexingDecisions().empty());
+	EXPECT_TRUE((entityManager.hasIndex<ComponentA, ComponentB>()));
+}
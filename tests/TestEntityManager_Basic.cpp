@@ -5,6 +5,8 @@
 
 #include "raccoon-ecs/entity_manager.h"
 
+#include "tests/utils/allocation_counter.h"
+
 namespace TestEntityManager_Basic_Internal
 {
 	enum ComponentType
@@ -473,6 +475,231 @@ TEST(EntityManager, MatchingEntityCountCanBeGathered)
 	EXPECT_EQ(static_cast<size_t>(2), entityManager.getMatchingEntitiesCount<TransformComponent>());
 }
 
+TEST(EntityManager, MultiComponentMatchingEntityCountCanBeGathered)
+{
+	using namespace TestEntityManager_Basic_Internal;
+
+	auto entityManagerData = PrepareEntityManager();
+	EntityManager& entityManager = entityManagerData->entityManager;
+
+	const Entity testEntity1 = entityManager.addEntity();
+	entityManager.addComponent<TransformComponent>(testEntity1);
+	entityManager.addComponent<MovementComponent>(testEntity1);
+
+	const Entity testEntity2 = entityManager.addEntity();
+	entityManager.addComponent<TransformComponent>(testEntity2);
+	entityManager.addComponent<MovementComponent>(testEntity2);
+	entityManager.addComponent<EmptyComponent>(testEntity2);
+
+	const Entity testEntity3 = entityManager.addEntity();
+	entityManager.addComponent<TransformComponent>(testEntity3);
+
+	EXPECT_EQ(static_cast<size_t>(2), (entityManager.getMatchingEntitiesCount<TransformComponent, MovementComponent>()));
+	EXPECT_EQ(static_cast<size_t>(1), (entityManager.getMatchingEntitiesCount<TransformComponent, MovementComponent, EmptyComponent>()));
+	EXPECT_EQ(static_cast<size_t>(0), (entityManager.getMatchingEntitiesCount<TransformComponent, NotUsedComponent>()));
+
+	entityManager.removeComponent<MovementComponent>(testEntity1);
+	EXPECT_EQ(static_cast<size_t>(1), (entityManager.getMatchingEntitiesCount<TransformComponent, MovementComponent>()));
+
+	entityManager.addComponent<MovementComponent>(testEntity3);
+	EXPECT_EQ(static_cast<size_t>(2), (entityManager.getMatchingEntitiesCount<TransformComponent, MovementComponent>()));
+
+	entityManager.removeEntity(testEntity2);
+	EXPECT_EQ(static_cast<size_t>(1), (entityManager.getMatchingEntitiesCount<TransformComponent, MovementComponent>()));
+	EXPECT_EQ(static_cast<size_t>(0), (entityManager.getMatchingEntitiesCount<TransformComponent, MovementComponent, EmptyComponent>()));
+
+	entityManager.scheduleAddComponent<MovementComponent>(testEntity1);
+	EXPECT_EQ(static_cast<size_t>(1), (entityManager.getMatchingEntitiesCount<TransformComponent, MovementComponent>()));
+	entityManager.executeScheduledActions();
+	EXPECT_EQ(static_cast<size_t>(2), (entityManager.getMatchingEntitiesCount<TransformComponent, MovementComponent>()));
+
+	EntityManager entityManager2(entityManagerData->componentFactory);
+	entityManager.transferEntityTo(entityManager2, testEntity1);
+	EXPECT_EQ(static_cast<size_t>(1), (entityManager.getMatchingEntitiesCount<TransformComponent, MovementComponent>()));
+	EXPECT_EQ(static_cast<size_t>(1), (entityManager2.getMatchingEntitiesCount<TransformComponent, MovementComponent>()));
+}
+
+TEST(EntityManager, MultiComponentMatchingEntityCountIsKeptForIndexes)
+{
+	using namespace TestEntityManager_Basic_Internal;
+
+	auto entityManagerData = PrepareEntityManager();
+	EntityManager& entityManager = entityManagerData->entityManager;
+
+	const Entity testEntity1 = entityManager.addEntity();
+	entityManager.addComponent<TransformComponent>(testEntity1);
+	entityManager.addComponent<MovementComponent>(testEntity1);
+
+	entityManager.initIndex<TransformComponent, MovementComponent>();
+	EXPECT_EQ(static_cast<size_t>(1), (entityManager.getMatchingEntitiesCount<TransformComponent, MovementComponent>()));
+
+	const Entity testEntity2 = entityManager.addEntity();
+	entityManager.addComponent<MovementComponent>(testEntity2);
+	entityManager.addComponent<TransformComponent>(testEntity2);
+	EXPECT_EQ(static_cast<size_t>(2), (entityManager.getMatchingEntitiesCount<TransformComponent, MovementComponent>()));
+	// the order of components in the query doesn't matter
+	EXPECT_EQ(static_cast<size_t>(2), (entityManager.getMatchingEntitiesCount<MovementComponent, TransformComponent>()));
+
+	EntityManager entityManagerCopy(entityManagerData->componentFactory);
+	entityManagerCopy.overrideBy(entityManager);
+	EXPECT_EQ(static_cast<size_t>(2), (entityManagerCopy.getMatchingEntitiesCount<TransformComponent, MovementComponent>()));
+
+	entityManager.removeEntity(testEntity1);
+	EXPECT_EQ(static_cast<size_t>(1), (entityManager.getMatchingEntitiesCount<TransformComponent, MovementComponent>()));
+}
+
+TEST(EntityManager, MatchingEntityCountEstimateIsUpperBound)
+{
+	using namespace TestEntityManager_Basic_Internal;
+
+	auto entityManagerData = PrepareEntityManager();
+	EntityManager& entityManager = entityManagerData->entityManager;
+
+	for (int i = 0; i < 10; ++i)
+	{
+		const Entity entity = entityManager.addEntity();
+		entityManager.addComponent<TransformComponent>(entity);
+		if (i % 2 == 0)
+		{
+			entityManager.addComponent<MovementComponent>(entity);
+		}
+		if (i % 3 == 0)
+		{
+			entityManager.addComponent<EmptyComponent>(entity);
+		}
+	}
+
+	const size_t exactCount = entityManager.getMatchingEntitiesCount<TransformComponent, MovementComponent, EmptyComponent>();
+	const size_t estimatedCount = entityManager.estimateMatchingEntitiesCount<TransformComponent, MovementComponent, EmptyComponent>();
+
+	EXPECT_EQ(static_cast<size_t>(2), exactCount);
+	EXPECT_GE(estimatedCount, exactCount);
+	EXPECT_LE(estimatedCount, entityManager.getMatchingEntitiesCount<EmptyComponent>());
+
+	EXPECT_EQ(static_cast<size_t>(0), (entityManager.estimateMatchingEntitiesCount<TransformComponent, NotUsedComponent>()));
+	EXPECT_EQ(static_cast<size_t>(10), entityManager.estimateMatchingEntitiesCount<TransformComponent>());
+}
+
+TEST(EntityManager, ClearingEntityManagerDestroysAllComponents)
+{
+	using namespace TestEntityManager_Basic_Internal;
+
+	auto entityManagerData = PrepareEntityManager();
+	EntityManager& entityManager = entityManagerData->entityManager;
+	int destructionsCount = 0;
+	int copiesCount = 0;
+	int movesCount = 0;
+
+	const auto destructionFn = [&destructionsCount]() { ++destructionsCount; };
+	const auto copyFn = [&copiesCount]() { ++copiesCount; };
+	const auto moveFn = [&movesCount]() { ++movesCount; };
+
+	for (int i = 0; i < 3; ++i)
+	{
+		const Entity testEntity = entityManager.addEntity();
+		entityManager.addComponent<TransformComponent>(testEntity);
+		LifetimeCheckerComponent* lifetimeChecker = entityManager.addComponent<LifetimeCheckerComponent>(testEntity);
+		lifetimeChecker->destructionCallback = destructionFn;
+		lifetimeChecker->copyCallback = copyFn;
+		lifetimeChecker->moveCallback = moveFn;
+	}
+
+	entityManager.clear(EntityManager::ClearMode::KeepCapacity);
+
+	EXPECT_EQ(destructionsCount, 3);
+	EXPECT_EQ(copiesCount, 0);
+	EXPECT_EQ(movesCount, 0);
+	EXPECT_FALSE(entityManager.hasAnyEntity());
+	EXPECT_EQ(static_cast<size_t>(0), entityManager.getMatchingEntitiesCount<TransformComponent>());
+	EXPECT_EQ(static_cast<size_t>(0), entityManager.getMatchingEntitiesCount<LifetimeCheckerComponent>());
+}
+
+TEST(EntityManager, ClearingEntityManagerResetsEntities)
+{
+	using namespace TestEntityManager_Basic_Internal;
+
+	auto entityManagerData = PrepareEntityManager();
+	EntityManager& entityManager = entityManagerData->entityManager;
+
+	const Entity firstEntity = entityManager.addEntity();
+	entityManager.removeEntity(firstEntity);
+	const Entity testEntity = entityManager.addEntity();
+	entityManager.addComponent<TransformComponent>(testEntity);
+
+	entityManager.clear(EntityManager::ClearMode::KeepCapacity);
+
+	EXPECT_FALSE(entityManager.hasEntity(testEntity));
+	const Entity newEntity = entityManager.addEntity();
+	EXPECT_EQ(firstEntity, newEntity);
+	EXPECT_FALSE(entityManager.doesEntityHaveComponent<TransformComponent>(newEntity));
+}
+
+TEST(EntityManager, ClearingEntityManagerKeepsIndexes)
+{
+	using namespace TestEntityManager_Basic_Internal;
+
+	auto entityManagerData = PrepareEntityManager();
+	EntityManager& entityManager = entityManagerData->entityManager;
+	entityManager.initIndex<TransformComponent, MovementComponent>();
+
+	{
+		const Entity testEntity = entityManager.addEntity();
+		entityManager.addComponent<TransformComponent>(testEntity)->pos = TestVector2(1, 2);
+		entityManager.addComponent<MovementComponent>(testEntity)->move = TestVector2(3, 4);
+	}
+
+	entityManager.clear(EntityManager::ClearMode::KeepCapacity);
+
+	EXPECT_TRUE((entityManager.hasIndex<TransformComponent, MovementComponent>()));
+
+	{
+		const Entity testEntity = entityManager.addEntity();
+		entityManager.addComponent<TransformComponent>(testEntity)->pos = TestVector2(5, 6);
+		entityManager.addComponent<MovementComponent>(testEntity)->move = TestVector2(7, 8);
+	}
+
+	std::vector<std::tuple<TransformComponent*, MovementComponent*>> resultComponents;
+	entityManager.getComponents<TransformComponent, MovementComponent>(resultComponents);
+	ASSERT_EQ(resultComponents.size(), static_cast<size_t>(1));
+	EXPECT_EQ(std::get<0>(resultComponents[0])->pos, TestVector2(5, 6));
+	EXPECT_EQ(std::get<1>(resultComponents[0])->move, TestVector2(7, 8));
+}
+
+TEST(EntityManager, RepopulatingClearedEntityManagerDoesNotAllocate)
+{
+	using namespace TestEntityManager_Basic_Internal;
+
+	auto entityManagerData = PrepareEntityManager();
+	EntityManager& entityManager = entityManagerData->entityManager;
+	entityManager.initIndex<TransformComponent, MovementComponent>();
+
+	const auto populate = [&entityManager]() {
+		for (int i = 0; i < 1000; ++i)
+		{
+			const Entity testEntity = entityManager.addEntity();
+			entityManager.addComponent<TransformComponent>(testEntity)->pos = TestVector2(i, i);
+			if (i % 2 == 0)
+			{
+				entityManager.addComponent<MovementComponent>(testEntity);
+			}
+		}
+	};
+
+	populate();
+	const size_t capacity = entityManager.getComponentPoolCapacity<TransformComponent>();
+
+	entityManager.clear(EntityManager::ClearMode::KeepCapacity);
+	EXPECT_EQ(capacity, entityManager.getComponentPoolCapacity<TransformComponent>());
+
+	{
+		AllocationCounter::ScopedAllocationCounter counter;
+		populate();
+		EXPECT_EQ(static_cast<size_t>(0), counter.getAllocationsCount());
+	}
+
+	EXPECT_EQ(static_cast<size_t>(500), (entityManager.getMatchingEntitiesCount<TransformComponent, MovementComponent>()));
+}
+
 TEST(EntityManager, EntityManagerCanBeCloned)
 {
 	using namespace TestEntityManager_Basic_Internal;
@@ -0,0 +1,323 @@
+#include <gtest/gtest.h>
+
+#include <span>
+#include <vector>
+
+#include "raccoon-ecs/entity_manager.h"
+
+namespace TestEntityManager_BlobArena_Internal
+{
+	enum ComponentType
+	{
+		PathComponentId,
+	};
+
+	using ComponentFactory = RaccoonEcs::ComponentFactoryImpl<ComponentType>;
+	using EntityManager = RaccoonEcs::EntityManagerImpl<ComponentType>;
+	using Entity = RaccoonEcs::Entity;
+
+	struct Waypoint
+	{
+		int x;
+		int y;
+	};
+
+	struct PathComponent
+	{
+		RaccoonEcs::BlobHandle<Waypoint> waypoints;
+
+		static ComponentType GetTypeId() { return PathComponentId; };
+	};
+
+	struct EntityManagerData
+	{
+		ComponentFactory componentFactory;
+		EntityManager entityManager{componentFactory};
+	};
+
+	static void RegisterComponents(ComponentFactory& inOutFactory)
+	{
+		inOutFactory.registerComponent<PathComponent>();
+		// the blob referenced by the handle is released together with the component
+		inOutFactory.registerBlobHandle<PathComponent>(&PathComponent::waypoints);
+	}
+
+	static std::unique_ptr<EntityManagerData> PrepareEntityManager()
+	{
+		auto data = std::make_unique<EntityManagerData>();
+		RegisterComponents(data->componentFactory);
+		return data;
+	}
+
+	static void fillWaypoints(std::span<Waypoint> waypoints, int base)
+	{
+		for (size_t i = 0; i < waypoints.size(); ++i)
+		{
+			waypoints[i] = Waypoint{base + static_cast<int>(i), base};
+		}
+	}
+
+	static std::vector<Entity> addEntitiesWithPaths(EntityManager& entityManager, int count, size_t waypointsCount)
+	{
+		std::vector<Entity> entities;
+		for (int i = 0; i < count; ++i)
+		{
+			const Entity entity = entityManager.addEntity();
+			PathComponent* path = entityManager.addComponent<PathComponent>(entity);
+			path->waypoints = entityManager.getBlobArena().allocate<Waypoint>(waypointsCount);
+			fillWaypoints(entityManager.getBlobArena().get(path->waypoints), i * 100);
+			entities.push_back(entity);
+		}
+		return entities;
+	}
+} // namespace EntityManagerTestInternals
+
+TEST(BlobArena, DefaultHandle_IsNotValid)
+{
+	using namespace TestEntityManager_BlobArena_Internal;
+
+	const RaccoonEcs::BlobHandle<Waypoint> handle;
+	EXPECT_FALSE(handle.isValid());
+}
+
+TEST(BlobArena, AllocateBlob_GetBlob_DataIsStoredInArena)
+{
+	using namespace TestEntityManager_BlobArena_Internal;
+
+	auto entityManagerData = PrepareEntityManager();
+	EntityManager& entityManager = entityManagerData->entityManager;
+
+	const Entity entity = entityManager.addEntity();
+	PathComponent* path = entityManager.addComponent<PathComponent>(entity);
+	path->waypoints = entityManager.getBlobArena().allocate<Waypoint>(5);
+	EXPECT_TRUE(path->waypoints.isValid());
+
+	std::span<Waypoint> waypoints = entityManager.getBlobArena().get(path->waypoints);
+	ASSERT_EQ(static_cast<size_t>(5), waypoints.size());
+	fillWaypoints(waypoints, 10);
+
+	const EntityManager& constEntityManager = entityManager;
+	std::span<const Waypoint> constWaypoints = constEntityManager.getBlobArena().get(path->waypoints);
+	ASSERT_EQ(static_cast<size_t>(5), constWaypoints.size());
+	EXPECT_EQ(10, constWaypoints[0].x);
+	EXPECT_EQ(14, constWaypoints[4].x);
+}
+
+TEST(BlobArena, ResizeBlob_ExistingElementsArePreserved)
+{
+	using namespace TestEntityManager_BlobArena_Internal;
+
+	auto entityManagerData = PrepareEntityManager();
+	EntityManager& entityManager = entityManagerData->entityManager;
+	auto& blobArena = entityManager.getBlobArena();
+
+	const RaccoonEcs::BlobHandle<Waypoint> handle1 = blobArena.allocate<Waypoint>(3);
+	fillWaypoints(blobArena.get(handle1), 0);
+	const RaccoonEcs::BlobHandle<Waypoint> handle2 = blobArena.allocate<Waypoint>(3);
+	fillWaypoints(blobArena.get(handle2), 100);
+
+	// growing a blob that is not the last one in the arena relocates it, but the handle stays the same
+	blobArena.resize(handle1, 10);
+	ASSERT_EQ(static_cast<size_t>(10), blobArena.get(handle1).size());
+	EXPECT_EQ(2, blobArena.get(handle1)[2].x);
+	EXPECT_EQ(102, blobArena.get(handle2)[2].x);
+
+	blobArena.resize(handle1, 2);
+	ASSERT_EQ(static_cast<size_t>(2), blobArena.get(handle1).size());
+	EXPECT_EQ(1, blobArena.get(handle1)[1].x);
+}
+
+TEST(BlobArena, ReleaseBlobsAndCompact_RemainingHandlesStayValid)
+{
+	using namespace TestEntityManager_BlobArena_Internal;
+
+	auto entityManagerData = PrepareEntityManager();
+	EntityManager& entityManager = entityManagerData->entityManager;
+	auto& blobArena = entityManager.getBlobArena();
+
+	std::vector<RaccoonEcs::BlobHandle<Waypoint>> handles;
+	for (int i = 0; i < 10; ++i)
+	{
+		handles.push_back(blobArena.allocate<Waypoint>(16));
+		fillWaypoints(blobArena.get(handles.back()), i * 100);
+	}
+
+	const size_t usedBytesBeforeRelease = blobArena.getUsedBytes();
+	for (size_t i = 0; i < handles.size(); i += 2)
+	{
+		blobArena.release(handles[i]);
+	}
+
+	blobArena.compact();
+
+	EXPECT_LT(blobArena.getUsedBytes(), usedBytesBeforeRelease);
+	for (size_t i = 1; i < handles.size(); i += 2)
+	{
+		std::span<Waypoint> waypoints = blobArena.get(handles[i]);
+		ASSERT_EQ(static_cast<size_t>(16), waypoints.size());
+		EXPECT_EQ(static_cast<int>(i) * 100, waypoints[0].x);
+		EXPECT_EQ(static_cast<int>(i) * 100 + 15, waypoints[15].x);
+	}
+}
+
+TEST(BlobArena, RemoveComponent_BlobIsReleased)
+{
+	using namespace TestEntityManager_BlobArena_Internal;
+
+	auto entityManagerData = PrepareEntityManager();
+	EntityManager& entityManager = entityManagerData->entityManager;
+	auto& blobArena = entityManager.getBlobArena();
+
+	const std::vector<Entity> entities = addEntitiesWithPaths(entityManager, 3, 16);
+	EXPECT_EQ(static_cast<size_t>(3), blobArena.getLiveBlobsCount());
+	const size_t usedBytesBeforeRemoval = blobArena.getUsedBytes();
+
+	entityManager.removeComponent<PathComponent>(entities[1]);
+
+	EXPECT_EQ(static_cast<size_t>(2), blobArena.getLiveBlobsCount());
+	EXPECT_LE(blobArena.getUsedBytes() + 16 * sizeof(Waypoint), usedBytesBeforeRemoval);
+}
+
+TEST(BlobArena, RemoveEntity_BlobIsReleased)
+{
+	using namespace TestEntityManager_BlobArena_Internal;
+
+	auto entityManagerData = PrepareEntityManager();
+	EntityManager& entityManager = entityManagerData->entityManager;
+	auto& blobArena = entityManager.getBlobArena();
+
+	const std::vector<Entity> entities = addEntitiesWithPaths(entityManager, 3, 16);
+	const size_t usedBytesBeforeRemoval = blobArena.getUsedBytes();
+
+	entityManager.removeEntity(entities[0]);
+	entityManager.removeEntity(entities[2]);
+
+	EXPECT_EQ(static_cast<size_t>(1), blobArena.getLiveBlobsCount());
+	EXPECT_LE(blobArena.getUsedBytes() + 2 * 16 * sizeof(Waypoint), usedBytesBeforeRemoval);
+}
+
+TEST(BlobArena, RemoveComponentsAndCompact_RemainingComponentsResolveToTheirData)
+{
+	using namespace TestEntityManager_BlobArena_Internal;
+
+	auto entityManagerData = PrepareEntityManager();
+	EntityManager& entityManager = entityManagerData->entityManager;
+	auto& blobArena = entityManager.getBlobArena();
+
+	const std::vector<Entity> entities = addEntitiesWithPaths(entityManager, 10, 16);
+
+	for (size_t i = 0; i < entities.size(); i += 2)
+	{
+		if (i % 4 == 0)
+		{
+			entityManager.removeEntity(entities[i]);
+		}
+		else
+		{
+			entityManager.removeComponent<PathComponent>(entities[i]);
+		}
+	}
+
+	// compaction moves the surviving blobs into the gaps left by the removed components
+	blobArena.compact();
+
+	EXPECT_EQ(static_cast<size_t>(5), blobArena.getLiveBlobsCount());
+	for (size_t i = 1; i < entities.size(); i += 2)
+	{
+		auto [path] = entityManager.getEntityComponents<PathComponent>(entities[i]);
+		ASSERT_NE(nullptr, path);
+		std::span<Waypoint> waypoints = blobArena.get(path->waypoints);
+		ASSERT_EQ(static_cast<size_t>(16), waypoints.size());
+		EXPECT_EQ(static_cast<int>(i) * 100, waypoints[0].x);
+		EXPECT_EQ(static_cast<int>(i) * 100 + 15, waypoints[15].x);
+	}
+}
+
+TEST(BlobArena, TransferEntity_BlobIsMovedToDestinationArena)
+{
+	using namespace TestEntityManager_BlobArena_Internal;
+
+	auto entityManagerData = PrepareEntityManager();
+	EntityManager& entityManager1 = entityManagerData->entityManager;
+	EntityManager entityManager2(entityManagerData->componentFactory);
+
+	const std::vector<Entity> entities = addEntitiesWithPaths(entityManager1, 3, 16);
+	const size_t sourceUsedBytesBeforeTransfer = entityManager1.getBlobArena().getUsedBytes();
+
+	const Entity transferredEntity = entityManager1.transferEntityTo(entityManager2, entities[1]);
+
+	// the blob is copied into the destination arena and released from the source one
+	EXPECT_EQ(static_cast<size_t>(2), entityManager1.getBlobArena().getLiveBlobsCount());
+	EXPECT_LE(entityManager1.getBlobArena().getUsedBytes() + 16 * sizeof(Waypoint), sourceUsedBytesBeforeTransfer);
+	EXPECT_EQ(static_cast<size_t>(1), entityManager2.getBlobArena().getLiveBlobsCount());
+
+	auto [path] = entityManager2.getEntityComponents<PathComponent>(transferredEntity);
+	ASSERT_NE(nullptr, path);
+	std::span<Waypoint> waypoints = entityManager2.getBlobArena().get(path->waypoints);
+	ASSERT_EQ(static_cast<size_t>(16), waypoints.size());
+	EXPECT_EQ(100, waypoints[0].x);
+	EXPECT_EQ(115, waypoints[15].x);
+
+	// the entities left in the source still resolve to their own data
+	auto [sourcePath] = entityManager1.getEntityComponents<PathComponent>(entities[2]);
+	ASSERT_NE(nullptr, sourcePath);
+	EXPECT_EQ(200, entityManager1.getBlobArena().get(sourcePath->waypoints)[0].x);
+}
+
+TEST(BlobArena, ClearKeepingCapacity_BlobsAreReleased)
+{
+	using namespace TestEntityManager_BlobArena_Internal;
+
+	auto entityManagerData = PrepareEntityManager();
+	EntityManager& entityManager = entityManagerData->entityManager;
+	auto& blobArena = entityManager.getBlobArena();
+
+	addEntitiesWithPaths(entityManager, 5, 16);
+	ASSERT_EQ(static_cast<size_t>(5), blobArena.getLiveBlobsCount());
+
+	entityManager.clear(EntityManager::ClearMode::KeepCapacity);
+
+	EXPECT_EQ(static_cast<size_t>(0), blobArena.getLiveBlobsCount());
+	EXPECT_EQ(static_cast<size_t>(0), blobArena.getUsedBytes());
+
+	const std::vector<Entity> entities = addEntitiesWithPaths(entityManager, 2, 4);
+	EXPECT_EQ(static_cast<size_t>(2), blobArena.getLiveBlobsCount());
+	auto [path] = entityManager.getEntityComponents<PathComponent>(entities[1]);
+	ASSERT_NE(nullptr, path);
+	EXPECT_EQ(100, blobArena.get(path->waypoints)[0].x);
+}
+
+TEST(BlobArena, CloneEntityManager_BlobsAreCopiedAndHandlesResolveInCopy)
+{
+	using namespace TestEntityManager_BlobArena_Internal;
+
+	auto entityManagerData = PrepareEntityManager();
+	EntityManager& entityManager = entityManagerData->entityManager;
+
+	std::vector<Entity> entities;
+	for (int i = 0; i < 20; ++i)
+	{
+		const Entity entity = entityManager.addEntity();
+		PathComponent* path = entityManager.addComponent<PathComponent>(entity);
+		path->waypoints = entityManager.getBlobArena().allocate<Waypoint>(static_cast<size_t>(i + 1));
+		fillWaypoints(entityManager.getBlobArena().get(path->waypoints), i * 10);
+		entities.push_back(entity);
+	}
+
+	EntityManager entityManagerCopy(entityManagerData->componentFactory);
+	entityManagerCopy.overrideBy(entityManager);
+
+	for (int i = 0; i < 20; ++i)
+	{
+		auto [path] = entityManagerCopy.getEntityComponents<PathComponent>(entities[i]);
+		ASSERT_NE(nullptr, path);
+		std::span<Waypoint> waypoints = entityManagerCopy.getBlobArena().get(path->waypoints);
+		ASSERT_EQ(static_cast<size_t>(i + 1), waypoints.size());
+		EXPECT_EQ(i * 10, waypoints[0].x);
+		waypoints[0].x = -1;
+	}
+
+	// the copy owns its own arena
+	auto [originalPath] = entityManager.getEntityComponents<PathComponent>(entities[0]);
+	EXPECT_EQ(0, entityManager.getBlobArena().get(originalPath->waypoints)[0].x);
+}
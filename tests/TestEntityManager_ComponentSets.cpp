@@ -1,6 +1,9 @@
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <functional>
+#include <ranges>
+#include <tuple>
 #include <vector>
 
 #include "raccoon-ecs/entity_manager.h"
@@ -397,3 +400,480 @@ TEST(EntityManager, ComponentSetsWithEntitiesAndAdditionalDataCanBeCollected)
 		}
 	}
 }
+
+TEST(EntityManager, ComponentSetsCanBeIteratedOverWithView)
+{
+	using namespace TestEntityManager_ComponentSets_Internal;
+
+	auto entityManagerData = PrepareEntityManager();
+	EntityManager& entityManager = entityManagerData->entityManager;
+
+	const Entity testEntity1 = entityManager.addEntity();
+	entityManager.addComponent<TransformComponent>(testEntity1)->pos = TestVector2(1, 2);
+	entityManager.addComponent<MovementComponent>(testEntity1);
+
+	const Entity testEntity2 = entityManager.addEntity();
+	entityManager.addComponent<TransformComponent>(testEntity2)->pos = TestVector2(3, 4);
+	entityManager.addComponent<EmptyComponent>(testEntity2);
+
+	static_assert(std::ranges::forward_range<decltype(entityManager.view<TransformComponent>())>);
+
+	{
+		int iterationsCount = 0;
+		for (auto [movement] : entityManager.view<MovementComponent>())
+		{
+			EXPECT_NE(nullptr, movement);
+			++iterationsCount;
+		}
+		EXPECT_EQ(1, iterationsCount);
+	}
+
+	{
+		int iterationsCount = 0;
+		auto transformView = entityManager.view<TransformComponent>();
+		for (auto [transform] : transformView)
+		{
+			transform->pos.x += 10;
+			++iterationsCount;
+		}
+		EXPECT_EQ(2, iterationsCount);
+
+		// iterate the second time to check that the view can be reused
+		for (auto [transform] : transformView)
+		{
+			EXPECT_GE(transform->pos.x, 10);
+			++iterationsCount;
+		}
+		EXPECT_EQ(4, iterationsCount);
+	}
+
+	{
+		int iterationsCount = 0;
+		for (auto [empty, transform] : entityManager.view<EmptyComponent, TransformComponent>())
+		{
+			EXPECT_NE(nullptr, empty);
+			EXPECT_EQ(TestVector2(13, 4), transform->pos);
+			++iterationsCount;
+		}
+		EXPECT_EQ(1, iterationsCount);
+	}
+}
+
+TEST(EntityManager, ComponentSetsWithEntitiesCanBeIteratedOverWithView)
+{
+	using namespace TestEntityManager_ComponentSets_Internal;
+
+	auto entityManagerData = PrepareEntityManager();
+	EntityManager& entityManager = entityManagerData->entityManager;
+
+	const Entity testEntity1 = entityManager.addEntity();
+	entityManager.addComponent<TransformComponent>(testEntity1);
+	entityManager.addComponent<MovementComponent>(testEntity1);
+
+	const Entity testEntity2 = entityManager.addEntity();
+	entityManager.addComponent<TransformComponent>(testEntity2);
+	entityManager.addComponent<EmptyComponent>(testEntity2);
+
+	{
+		int iterationsCount = 0;
+		for (auto [entity, movement] : entityManager.viewWithEntities<MovementComponent>())
+		{
+			EXPECT_EQ(testEntity1, entity);
+			EXPECT_NE(nullptr, movement);
+			++iterationsCount;
+		}
+		EXPECT_EQ(1, iterationsCount);
+	}
+
+	{
+		int iterationsCount = 0;
+		for (auto [entity, empty, transform] : entityManager.viewWithEntities<EmptyComponent, TransformComponent>())
+		{
+			EXPECT_EQ(testEntity2, entity);
+			++iterationsCount;
+		}
+		EXPECT_EQ(1, iterationsCount);
+	}
+}
+
+TEST(EntityManager, ComponentSetViewCanBeComposedWithRangeAdaptors)
+{
+	using namespace TestEntityManager_ComponentSets_Internal;
+
+	auto entityManagerData = PrepareEntityManager();
+	EntityManager& entityManager = entityManagerData->entityManager;
+
+	for (int i = 0; i < 10; ++i)
+	{
+		const Entity entity = entityManager.addEntity();
+		entityManager.addComponent<TransformComponent>(entity)->pos = TestVector2(i, 0);
+	}
+
+	auto filteredView = entityManager.view<const TransformComponent>()
+		| std::views::filter([](const auto& componentSet) { return std::get<0>(componentSet)->pos.x % 2 == 0; });
+
+	int sum = 0;
+	for (auto [transform] : filteredView)
+	{
+		sum += transform->pos.x;
+	}
+	EXPECT_EQ(20, sum);
+
+	EXPECT_EQ(3, std::ranges::distance(entityManager.view<const TransformComponent>() | std::views::take(3)));
+}
+
+TEST(EntityManager, ComponentSetsCanBeCollectedIntoArrays)
+{
+	using namespace TestEntityManager_ComponentSets_Internal;
+
+	auto entityManagerData = PrepareEntityManager();
+	EntityManager& entityManager = entityManagerData->entityManager;
+
+	const Entity testEntity1 = entityManager.addEntity();
+	entityManager.addComponent<TransformComponent>(testEntity1);
+	entityManager.addComponent<MovementComponent>(testEntity1);
+
+	const Entity testEntity2 = entityManager.addEntity();
+	const TransformComponent* transform2 = entityManager.addComponent<TransformComponent>(testEntity2);
+	const EmptyComponent* empty2 = entityManager.addComponent<EmptyComponent>(testEntity2);
+
+	{
+		RaccoonEcs::ComponentArrays<TransformComponent> arrays;
+		entityManager.getComponentArrays(arrays);
+		EXPECT_EQ(static_cast<size_t>(2u), arrays.size());
+		EXPECT_EQ(static_cast<size_t>(2u), arrays.getComponents<TransformComponent>().size());
+		EXPECT_TRUE(arrays.getEntities().empty());
+
+		// call the second time to check that arrays are appended to
+		entityManager.getComponentArrays(arrays);
+		EXPECT_EQ(static_cast<size_t>(4u), arrays.size());
+		EXPECT_EQ(static_cast<size_t>(4u), arrays.getComponents<TransformComponent>().size());
+
+		arrays.clear();
+		EXPECT_EQ(static_cast<size_t>(0u), arrays.size());
+	}
+
+	{
+		RaccoonEcs::ComponentArrays<EmptyComponent, TransformComponent> arrays;
+		entityManager.getComponentArrays(arrays);
+		ASSERT_EQ(static_cast<size_t>(1u), arrays.size());
+		EXPECT_EQ(empty2, arrays.getComponents<EmptyComponent>()[0]);
+		EXPECT_EQ(transform2, arrays.getComponents<TransformComponent>()[0]);
+	}
+}
+
+TEST(EntityManager, ComponentSetsWithEntitiesCanBeCollectedIntoArrays)
+{
+	using namespace TestEntityManager_ComponentSets_Internal;
+
+	auto entityManagerData = PrepareEntityManager();
+	EntityManager& entityManager = entityManagerData->entityManager;
+
+	const Entity testEntity1 = entityManager.addEntity();
+	const TransformComponent* transform1 = entityManager.addComponent<TransformComponent>(testEntity1);
+	entityManager.addComponent<MovementComponent>(testEntity1);
+
+	const Entity testEntity2 = entityManager.addEntity();
+	const TransformComponent* transform2 = entityManager.addComponent<TransformComponent>(testEntity2);
+	entityManager.addComponent<EmptyComponent>(testEntity2);
+
+	RaccoonEcs::ComponentArrays<const TransformComponent> arrays;
+	entityManager.getComponentArraysWithEntities(arrays);
+	ASSERT_EQ(static_cast<size_t>(2u), arrays.size());
+	ASSERT_EQ(static_cast<size_t>(2u), arrays.getEntities().size());
+
+	// rows in all arrays are kept in the same order
+	for (size_t i = 0; i < arrays.size(); ++i)
+	{
+		const Entity entity = arrays.getEntities()[i];
+		const TransformComponent* transform = arrays.getComponents<const TransformComponent>()[i];
+		EXPECT_EQ(entity == testEntity1 ? transform1 : transform2, transform);
+	}
+}
+
+TEST(EntityManager, ComponentSetsWithAdditionalDataCanBeCollectedIntoArrays)
+{
+	using namespace TestEntityManager_ComponentSets_Internal;
+
+	ComponentFactory componentFactory;
+	RegisterComponents(componentFactory);
+	EntityManager entityManager1(componentFactory);
+	EntityManager entityManager2(componentFactory);
+
+	for (int i = 0; i < 2; ++i)
+	{
+		const Entity testEntity = entityManager1.addEntity();
+		entityManager1.addComponent<TransformComponent>(testEntity);
+		entityManager1.addComponent<EmptyComponent>(testEntity);
+	}
+
+	for (int i = 0; i < 3; ++i)
+	{
+		const Entity testEntity = entityManager2.addEntity();
+		entityManager2.addComponent<TransformComponent>(testEntity);
+		entityManager2.addComponent<EmptyComponent>(testEntity);
+	}
+
+	RaccoonEcs::ComponentArraysWithExtraData<int, EmptyComponent, TransformComponent> arrays;
+	entityManager1.getComponentArrays(arrays, 10);
+	entityManager2.getComponentArrays(arrays, 20);
+	EXPECT_EQ(static_cast<size_t>(5u), arrays.size());
+
+	// extra data is stored once per collected segment, not once per row
+	const auto& segments = arrays.getSegments();
+	ASSERT_EQ(static_cast<size_t>(2u), segments.size());
+	EXPECT_EQ(10, segments[0].extraData);
+	EXPECT_EQ(static_cast<size_t>(0u), segments[0].begin);
+	EXPECT_EQ(static_cast<size_t>(2u), segments[0].end);
+	EXPECT_EQ(20, segments[1].extraData);
+	EXPECT_EQ(static_cast<size_t>(2u), segments[1].begin);
+	EXPECT_EQ(static_cast<size_t>(5u), segments[1].end);
+}
+
+TEST(EntityManager, FirstMatchingComponentSetCanBeFound)
+{
+	using namespace TestEntityManager_ComponentSets_Internal;
+
+	auto entityManagerData = PrepareEntityManager();
+	EntityManager& entityManager = entityManagerData->entityManager;
+
+	const Entity testEntity1 = entityManager.addEntity();
+	entityManager.addComponent<TransformComponent>(testEntity1)->pos = TestVector2(1, 0);
+	entityManager.addComponent<MovementComponent>(testEntity1);
+
+	const Entity testEntity2 = entityManager.addEntity();
+	entityManager.addComponent<TransformComponent>(testEntity2)->pos = TestVector2(2, 0);
+	entityManager.addComponent<EmptyComponent>(testEntity2);
+
+	{
+		const RaccoonEcs::OptionalEntity foundEntity = entityManager.findFirst<const TransformComponent>([](const TransformComponent* transform) {
+			return transform->pos.x == 2;
+		});
+		EXPECT_EQ(testEntity2, foundEntity);
+	}
+
+	{
+		const RaccoonEcs::OptionalEntity foundEntity = entityManager.findFirst<const TransformComponent, const MovementComponent>([](const TransformComponent* transform, const MovementComponent*) {
+			return transform->pos.x == 2;
+		});
+		EXPECT_FALSE(foundEntity.isValid());
+	}
+}
+
+TEST(EntityManager, AnyStopsIteratingAfterFirstMatch)
+{
+	using namespace TestEntityManager_ComponentSets_Internal;
+
+	auto entityManagerData = PrepareEntityManager();
+	EntityManager& entityManager = entityManagerData->entityManager;
+
+	for (int i = 0; i < 10; ++i)
+	{
+		const Entity entity = entityManager.addEntity();
+		entityManager.addComponent<TransformComponent>(entity)->pos = TestVector2(i, 0);
+	}
+
+	{
+		int predicateCallsCount = 0;
+		const bool result = entityManager.any<const TransformComponent>([&predicateCallsCount](const TransformComponent*) {
+			++predicateCallsCount;
+			return true;
+		});
+		EXPECT_TRUE(result);
+		EXPECT_EQ(1, predicateCallsCount);
+	}
+
+	{
+		int predicateCallsCount = 0;
+		const bool result = entityManager.any<const TransformComponent>([&predicateCallsCount](const TransformComponent* transform) {
+			++predicateCallsCount;
+			return transform->pos.x > 100;
+		});
+		EXPECT_FALSE(result);
+		EXPECT_EQ(10, predicateCallsCount);
+	}
+
+	EXPECT_FALSE(entityManager.any<const MovementComponent>([](const MovementComponent*) { return true; }));
+}
+
+TEST(EntityManager, MatchingComponentSetsCanBeCounted)
+{
+	using namespace TestEntityManager_ComponentSets_Internal;
+
+	auto entityManagerData = PrepareEntityManager();
+	EntityManager& entityManager = entityManagerData->entityManager;
+
+	for (int i = 0; i < 10; ++i)
+	{
+		const Entity entity = entityManager.addEntity();
+		entityManager.addComponent<TransformComponent>(entity)->pos = TestVector2(i, 0);
+		if (i < 4)
+		{
+			entityManager.addComponent<EmptyComponent>(entity);
+		}
+	}
+
+	EXPECT_EQ(static_cast<size_t>(5u), entityManager.countIf<const TransformComponent>([](const TransformComponent* transform) {
+		return transform->pos.x % 2 == 0;
+	}));
+
+	EXPECT_EQ(static_cast<size_t>(2u), (entityManager.countIf<const EmptyComponent, const TransformComponent>([](const EmptyComponent*, const TransformComponent* transform) {
+		return transform->pos.x % 2 == 0;
+	})));
+}
+
+TEST(EntityManager, ComponentSetsCanBeReduced)
+{
+	using namespace TestEntityManager_ComponentSets_Internal;
+
+	auto entityManagerData = PrepareEntityManager();
+	EntityManager& entityManager = entityManagerData->entityManager;
+
+	for (int i = 1; i <= 100; ++i)
+	{
+		const Entity entity = entityManager.addEntity();
+		entityManager.addComponent<TransformComponent>(entity)->pos = TestVector2(i, 0);
+	}
+
+	const auto sumPositions = [](int sum, const TransformComponent* transform) {
+		return sum + transform->pos.x;
+	};
+
+	EXPECT_EQ(5050, entityManager.reduce<const TransformComponent>(0, sumPositions));
+	// the initial value is counted once, not once per partition
+	EXPECT_EQ(5150, entityManager.parallelReduce<const TransformComponent>(100, sumPositions, std::plus<int>(), 4));
+	EXPECT_EQ(0, entityManager.reduce<const MovementComponent>(0, [](int sum, const MovementComponent*) { return sum + 1; }));
+}
+
+TEST(EntityManager, ComponentSetsWithAlternativeComponentsCanBeIteratedOver)
+{
+	using namespace TestEntityManager_ComponentSets_Internal;
+
+	auto entityManagerData = PrepareEntityManager();
+	EntityManager& entityManager = entityManagerData->entityManager;
+
+	const Entity transformOnlyEntity = entityManager.addEntity();
+	entityManager.addComponent<TransformComponent>(transformOnlyEntity)->pos = TestVector2(1, 0);
+
+	const Entity movementOnlyEntity = entityManager.addEntity();
+	entityManager.addComponent<MovementComponent>(movementOnlyEntity)->move = TestVector2(2, 0);
+
+	const Entity entityWithBoth = entityManager.addEntity();
+	entityManager.addComponent<TransformComponent>(entityWithBoth)->pos = TestVector2(3, 0);
+	entityManager.addComponent<MovementComponent>(entityWithBoth)->move = TestVector2(3, 0);
+
+	const Entity entityWithNone = entityManager.addEntity();
+	entityManager.addComponent<EmptyComponent>(entityWithNone);
+
+	std::vector<Entity> visitedEntities;
+	entityManager.forEachComponentSetWithEntity<RaccoonEcs::AnyOf<TransformComponent, MovementComponent>>(
+		[&](Entity entity, TransformComponent* transform, MovementComponent* movement) {
+			visitedEntities.push_back(entity);
+			if (entity == transformOnlyEntity)
+			{
+				ASSERT_NE(nullptr, transform);
+				EXPECT_EQ(1, transform->pos.x);
+				EXPECT_EQ(nullptr, movement);
+			}
+			else if (entity == movementOnlyEntity)
+			{
+				EXPECT_EQ(nullptr, transform);
+				ASSERT_NE(nullptr, movement);
+				EXPECT_EQ(2, movement->move.x);
+			}
+			else if (entity == entityWithBoth)
+			{
+				EXPECT_NE(nullptr, transform);
+				EXPECT_NE(nullptr, movement);
+			}
+			else
+			{
+				ADD_FAILURE() << "Entity without any of the components was visited";
+			}
+		}
+	);
+
+	// every matching entity is visited exactly once, even if it has more than one alternative
+	std::vector<Entity> expectedEntities{transformOnlyEntity, movementOnlyEntity, entityWithBoth};
+	std::sort(expectedEntities.begin(), expectedEntities.end());
+	std::sort(visitedEntities.begin(), visitedEntities.end());
+	EXPECT_EQ(expectedEntities, visitedEntities);
+
+	EXPECT_EQ(static_cast<size_t>(3), (entityManager.getMatchingEntitiesCount<RaccoonEcs::AnyOf<TransformComponent, MovementComponent>>()));
+}
+
+TEST(EntityManager, ComponentSetsWithAlternativeComponentsCanBeCombinedWithRequiredComponents)
+{
+	using namespace TestEntityManager_ComponentSets_Internal;
+
+	auto entityManagerData = PrepareEntityManager();
+	EntityManager& entityManager = entityManagerData->entityManager;
+
+	const Entity testEntity1 = entityManager.addEntity();
+	entityManager.addComponent<EmptyComponent>(testEntity1);
+	entityManager.addComponent<TransformComponent>(testEntity1);
+
+	const Entity testEntity2 = entityManager.addEntity();
+	entityManager.addComponent<EmptyComponent>(testEntity2);
+	entityManager.addComponent<MovementComponent>(testEntity2);
+
+	const Entity testEntity3 = entityManager.addEntity();
+	entityManager.addComponent<TransformComponent>(testEntity3);
+	entityManager.addComponent<MovementComponent>(testEntity3);
+
+	const Entity testEntity4 = entityManager.addEntity();
+	entityManager.addComponent<EmptyComponent>(testEntity4);
+
+	std::vector<std::tuple<Entity, EmptyComponent*, TransformComponent*, MovementComponent*>> components;
+	entityManager.getComponentsWithEntities<EmptyComponent, RaccoonEcs::AnyOf<TransformComponent, MovementComponent>>(components);
+
+	ASSERT_EQ(static_cast<size_t>(2), components.size());
+	std::sort(components.begin(), components.end(), [](const auto& a, const auto& b) {
+		return std::get<0>(a) < std::get<0>(b);
+	});
+	EXPECT_EQ(testEntity1, std::get<0>(components[0]));
+	EXPECT_NE(nullptr, std::get<1>(components[0]));
+	EXPECT_NE(nullptr, std::get<2>(components[0]));
+	EXPECT_EQ(nullptr, std::get<3>(components[0]));
+	EXPECT_EQ(testEntity2, std::get<0>(components[1]));
+	EXPECT_NE(nullptr, std::get<1>(components[1]));
+	EXPECT_EQ(nullptr, std::get<2>(components[1]));
+	EXPECT_NE(nullptr, std::get<3>(components[1]));
+}
+
+TEST(EntityManager, ComponentSetsWithAlternativeComponentsCanUseIndexes)
+{
+	using namespace TestEntityManager_ComponentSets_Internal;
+
+	auto entityManagerData = PrepareEntityManager();
+	EntityManager& entityManager = entityManagerData->entityManager;
+	entityManager.initIndex<EmptyComponent, TransformComponent>();
+	entityManager.initIndex<EmptyComponent, MovementComponent>();
+
+	for (int i = 0; i < 30; ++i)
+	{
+		const Entity entity = entityManager.addEntity();
+		if (i % 2 == 0)
+		{
+			entityManager.addComponent<EmptyComponent>(entity);
+		}
+		if (i % 3 == 0)
+		{
+			entityManager.addComponent<TransformComponent>(entity);
+		}
+		if (i % 5 == 0)
+		{
+			entityManager.addComponent<MovementComponent>(entity);
+		}
+	}
+
+	// i % 2 == 0 && (i % 3 == 0 || i % 5 == 0): 0, 6, 10, 12, 18, 20, 24
+	int iterationsCount = 0;
+	entityManager.forEachComponentSet<EmptyComponent, RaccoonEcs::AnyOf<TransformComponent, MovementComponent>>(
+		[&iterationsCount](EmptyComponent*, TransformComponent* transform, MovementComponent* movement) {
+			EXPECT_TRUE(transform != nullptr || movement != nullptr);
+			++iterationsCount;
+		}
+	);
+	EXPECT_EQ(7, iterationsCount);
+}
@@ -0,0 +1,232 @@
+#include <gtest/gtest.h>
+
+#include <tuple>
+#include <vector>
+
+#include "raccoon-ecs/entity_manager.h"
+
+namespace TestEntityManager_EnabledEntities_Internal
+{
+	enum ComponentType
+	{
+		TransformComponentId,
+		MovementComponentId,
+	};
+
+	using ComponentFactory = RaccoonEcs::ComponentFactoryImpl<ComponentType>;
+	using EntityManager = RaccoonEcs::EntityManagerImpl<ComponentType>;
+	using Entity = RaccoonEcs::Entity;
+	using IncludeDisabled = RaccoonEcs::IncludeDisabled;
+
+	struct TransformComponent
+	{
+		int x;
+		int y;
+
+		static ComponentType GetTypeId() { return TransformComponentId; };
+	};
+
+	struct MovementComponent
+	{
+		int dx;
+		int dy;
+
+		static ComponentType GetTypeId() { return MovementComponentId; };
+	};
+
+	struct EntityManagerData
+	{
+		ComponentFactory componentFactory;
+		EntityManager entityManager{componentFactory};
+	};
+
+	static void RegisterComponents(ComponentFactory& inOutFactory)
+	{
+		inOutFactory.registerComponent<TransformComponent>();
+		inOutFactory.registerComponent<MovementComponent>();
+	}
+
+	static std::unique_ptr<EntityManagerData> PrepareEntityManager()
+	{
+		auto data = std::make_unique<EntityManagerData>();
+		RegisterComponents(data->componentFactory);
+		return data;
+	}
+
+	static std::vector<Entity> addEntities(EntityManager& entityManager, int count)
+	{
+		std::vector<Entity> result;
+		for (int i = 0; i < count; ++i)
+		{
+			const Entity entity = entityManager.addEntity();
+			entityManager.addComponent<TransformComponent>(entity)->x = i;
+			entityManager.addComponent<MovementComponent>(entity);
+			result.push_back(entity);
+		}
+		return result;
+	}
+
+	static int countTransforms(EntityManager& entityManager)
+	{
+		int iterationsCount = 0;
+		entityManager.forEachComponentSet<TransformComponent>([&iterationsCount](TransformComponent*) {
+			++iterationsCount;
+		});
+		return iterationsCount;
+	}
+} // namespace EntityManagerTestInternals
+
+TEST(EntityManager, EnabledEntities_NewEntity_IsEnabledByDefault)
+{
+	using namespace TestEntityManager_EnabledEntities_Internal;
+
+	auto entityManagerData = PrepareEntityManager();
+	EntityManager& entityManager = entityManagerData->entityManager;
+
+	const Entity entity = entityManager.addEntity();
+	EXPECT_TRUE(entityManager.isEntityEnabled(entity));
+
+	entityManager.setEntityEnabled(entity, false);
+	EXPECT_FALSE(entityManager.isEntityEnabled(entity));
+	EXPECT_TRUE(entityManager.hasEntity(entity));
+
+	entityManager.setEntityEnabled(entity, true);
+	EXPECT_TRUE(entityManager.isEntityEnabled(entity));
+}
+
+TEST(EntityManager, EnabledEntities_DisableEntities_EntitiesAreExcludedFromQueries)
+{
+	using namespace TestEntityManager_EnabledEntities_Internal;
+
+	auto entityManagerData = PrepareEntityManager();
+	EntityManager& entityManager = entityManagerData->entityManager;
+	const std::vector<Entity> entities = addEntities(entityManager, 10);
+
+	entityManager.setEntityEnabled(entities[2], false);
+	entityManager.setEntityEnabled(entities[7], false);
+
+	EXPECT_EQ(8, countTransforms(entityManager));
+
+	entityManager.forEachComponentSetWithEntity<TransformComponent, MovementComponent>(
+		[&entities](Entity entity, TransformComponent*, MovementComponent*) {
+			EXPECT_NE(entities[2], entity);
+			EXPECT_NE(entities[7], entity);
+		}
+	);
+
+	std::vector<std::tuple<TransformComponent*>> components;
+	entityManager.getComponents<TransformComponent>(components);
+	EXPECT_EQ(static_cast<size_t>(8), components.size());
+
+	EXPECT_EQ(static_cast<size_t>(8), entityManager.getMatchingEntitiesCount<TransformComponent>());
+	EXPECT_EQ(static_cast<size_t>(8), (entityManager.getMatchingEntitiesCount<TransformComponent, MovementComponent>()));
+}
+
+TEST(EntityManager, EnabledEntities_QueryWithIncludeDisabled_DisabledEntitiesAreVisited)
+{
+	using namespace TestEntityManager_EnabledEntities_Internal;
+
+	auto entityManagerData = PrepareEntityManager();
+	EntityManager& entityManager = entityManagerData->entityManager;
+	const std::vector<Entity> entities = addEntities(entityManager, 10);
+
+	entityManager.setEntityEnabled(entities[3], false);
+
+	int iterationsCount = 0;
+	bool disabledEntityVisited = false;
+	entityManager.forEachComponentSetWithEntity<IncludeDisabled, TransformComponent>(
+		[&iterationsCount, &disabledEntityVisited, &entities](Entity entity, TransformComponent*) {
+			++iterationsCount;
+			disabledEntityVisited |= (entity == entities[3]);
+		}
+	);
+	EXPECT_EQ(10, iterationsCount);
+	EXPECT_TRUE(disabledEntityVisited);
+	EXPECT_EQ(static_cast<size_t>(10), (entityManager.getMatchingEntitiesCount<IncludeDisabled, TransformComponent>()));
+}
+
+TEST(EntityManager, EnabledEntities_DisableAndEnableEntity_ComponentsAreKeptInPlace)
+{
+	using namespace TestEntityManager_EnabledEntities_Internal;
+
+	auto entityManagerData = PrepareEntityManager();
+	EntityManager& entityManager = entityManagerData->entityManager;
+	const std::vector<Entity> entities = addEntities(entityManager, 5);
+
+	auto [transformBefore] = entityManager.getEntityComponents<TransformComponent>(entities[1]);
+
+	entityManager.setEntityEnabled(entities[1], false);
+
+	// direct access still works for disabled entities
+	auto [transformWhileDisabled] = entityManager.getEntityComponents<TransformComponent>(entities[1]);
+	EXPECT_EQ(transformBefore, transformWhileDisabled);
+	EXPECT_TRUE(entityManager.doesEntityHaveComponent<TransformComponent>(entities[1]));
+
+	entityManager.setEntityEnabled(entities[1], true);
+
+	auto [transformAfter] = entityManager.getEntityComponents<TransformComponent>(entities[1]);
+	EXPECT_EQ(transformBefore, transformAfter);
+	EXPECT_EQ(1, transformAfter->x);
+	EXPECT_EQ(5, countTransforms(entityManager));
+}
+
+TEST(EntityManager, EnabledEntities_DisableEntitiesWithIndex_EntitiesAreExcludedFromIndexedQueries)
+{
+	using namespace TestEntityManager_EnabledEntities_Internal;
+
+	auto entityManagerData = PrepareEntityManager();
+	EntityManager& entityManager = entityManagerData->entityManager;
+	entityManager.initIndex<TransformComponent, MovementComponent>();
+	const std::vector<Entity> entities = addEntities(entityManager, 10);
+
+	entityManager.setEntityEnabled(entities[0], false);
+
+	int iterationsCount = 0;
+	entityManager.forEachComponentSet<TransformComponent, MovementComponent>([&iterationsCount](TransformComponent*, MovementComponent*) {
+		++iterationsCount;
+	});
+	EXPECT_EQ(9, iterationsCount);
+
+	entityManager.setEntityEnabled(entities[0], true);
+
+	iterationsCount = 0;
+	entityManager.forEachComponentSet<TransformComponent, MovementComponent>([&iterationsCount](TransformComponent*, MovementComponent*) {
+		++iterationsCount;
+	});
+	EXPECT_EQ(10, iterationsCount);
+}
+
+TEST(EntityManager, EnabledEntities_RemoveDisabledEntity_NewEntityIsEnabled)
+{
+	using namespace TestEntityManager_EnabledEntities_Internal;
+
+	auto entityManagerData = PrepareEntityManager();
+	EntityManager& entityManager = entityManagerData->entityManager;
+
+	const Entity disabledEntity = entityManager.addEntity();
+	entityManager.setEntityEnabled(disabledEntity, false);
+	entityManager.removeEntity(disabledEntity);
+
+	// the slot of the removed entity can be reused, but the disabled state is not inherited
+	const Entity newEntity = entityManager.addEntity();
+	entityManager.addComponent<TransformComponent>(newEntity);
+	EXPECT_TRUE(entityManager.isEntityEnabled(newEntity));
+	EXPECT_EQ(1, countTransforms(entityManager));
+}
+
+TEST(EntityManager, EnabledEntities_CloneEntityManager_EnabledStateIsCopied)
+{
+	using namespace TestEntityManager_EnabledEntities_Internal;
+
+	auto entityManagerData = PrepareEntityManager();
+	EntityManager& entityManager = entityManagerData->entityManager;
+	const std::vector<Entity> entities = addEntities(entityManager, 4);
+	entityManager.setEntityEnabled(entities[1], false);
+
+	EntityManager entityManagerCopy(entityManagerData->componentFactory);
+	entityManagerCopy.overrideBy(entityManager);
+
+	EXPECT_FALSE(entityManagerCopy.isEntityEnabled(entities[1]));
+	EXPECT_TRUE(entityManagerCopy.isEntityEnabled(entities[0]));
+	EXPECT_EQ(3, countTransforms(entityManagerCopy));
+}
@@ -0,0 +1,288 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <filesystem>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "raccoon-ecs/entity_manager.h"
+
+namespace TestEntityManager_MappedStorage_Internal
+{
+	enum ComponentType
+	{
+		TransformComponentId,
+		MovementComponentId,
+	};
+
+	using ComponentFactory = RaccoonEcs::ComponentFactoryImpl<ComponentType>;
+	using EntityManager = RaccoonEcs::EntityManagerImpl<ComponentType>;
+	using Entity = RaccoonEcs::Entity;
+
+	struct TransformComponent
+	{
+		int x;
+		int y;
+
+		static ComponentType GetTypeId() { return TransformComponentId; };
+	};
+
+	struct MovementComponent
+	{
+		int dx;
+		int dy;
+
+		static ComponentType GetTypeId() { return MovementComponentId; };
+	};
+
+	static void RegisterComponents(ComponentFactory& inOutFactory)
+	{
+		inOutFactory.registerComponent<TransformComponent>();
+		inOutFactory.registerComponent<MovementComponent>();
+	}
+
+	// unique per run, so concurrent test runs from different processes or users don't touch each other's files
+	static std::string makeUniqueSuffix()
+	{
+		std::random_device randomDevice;
+		const auto timeSeed = static_cast<unsigned long long>(std::chrono::steady_clock::now().time_since_epoch().count());
+		std::mt19937_64 generator(timeSeed ^ (static_cast<unsigned long long>(randomDevice()) << 32) ^ randomDevice());
+		std::ostringstream stream;
+		stream << std::hex << generator();
+		return stream.str();
+	}
+
+	class TemporaryDirectory
+	{
+	public:
+		explicit TemporaryDirectory(const std::string& name)
+			: mPath(std::filesystem::temp_directory_path() / ("raccoon_ecs_tests_" + name + "_" + makeUniqueSuffix()))
+		{
+			// fails if the directory already exists, so a directory that belongs to someone else is never reused
+			if (!std::filesystem::create_directory(mPath))
+			{
+				throw std::runtime_error("Temporary directory already exists: " + mPath.string());
+			}
+		}
+
+		~TemporaryDirectory()
+		{
+			std::error_code errorCode;
+			std::filesystem::remove_all(mPath, errorCode);
+		}
+
+		TemporaryDirectory(const TemporaryDirectory&) = delete;
+		TemporaryDirectory& operator=(const TemporaryDirectory&) = delete;
+
+		const std::filesystem::path& getPath() const { return mPath; }
+
+	private:
+		std::filesystem::path mPath;
+	};
+
+	static RaccoonEcs::EntityManagerOptions makeMappedOptions(const std::filesystem::path& directory, RaccoonEcs::MappedStorageMode mode)
+	{
+		RaccoonEcs::EntityManagerOptions options;
+		options.storageBackend = RaccoonEcs::StorageBackend::MappedFiles;
+		options.mappedStorageDirectory = directory;
+		options.mappedStorageMode = mode;
+		return options;
+	}
+} // namespace EntityManagerTestInternals
+
+TEST(EntityManager, MappedStorage_AddComponents_RegularApiWorks)
+{
+	using namespace TestEntityManager_MappedStorage_Internal;
+
+	TemporaryDirectory directory("regular_api");
+
+	ComponentFactory componentFactory;
+	RegisterComponents(componentFactory);
+	EntityManager entityManager(componentFactory, makeMappedOptions(directory.getPath(), RaccoonEcs::MappedStorageMode::CreateNew));
+
+	for (int i = 0; i < 1000; ++i)
+	{
+		const Entity entity = entityManager.addEntity();
+		entityManager.addComponent<TransformComponent>(entity)->x = i;
+		if (i % 2 == 0)
+		{
+			entityManager.addComponent<MovementComponent>(entity)->dx = 1;
+		}
+	}
+
+	entityManager.forEachComponentSet<TransformComponent, MovementComponent>([](TransformComponent* transform, MovementComponent* movement) {
+		transform->x += movement->dx;
+	});
+
+	std::vector<std::tuple<TransformComponent*>> components;
+	entityManager.getComponents<TransformComponent>(components);
+	ASSERT_EQ(static_cast<size_t>(1000), components.size());
+
+	long long sum = 0;
+	for (auto [transform] : components)
+	{
+		sum += transform->x;
+	}
+	// 0 + 1 + ... + 999 plus one for each of the 500 moved entities
+	EXPECT_EQ(499500 + 500, sum);
+
+	EXPECT_FALSE(std::filesystem::is_empty(directory.getPath()));
+}
+
+TEST(EntityManager, MappedStorage_IterateOverComponents_SequentialAccessIsHinted)
+{
+	using namespace TestEntityManager_MappedStorage_Internal;
+
+	TemporaryDirectory directory("madvise");
+
+	ComponentFactory componentFactory;
+	RegisterComponents(componentFactory);
+	EntityManager entityManager(componentFactory, makeMappedOptions(directory.getPath(), RaccoonEcs::MappedStorageMode::CreateNew));
+
+	std::vector<Entity> entities;
+	for (int i = 0; i < 100; ++i)
+	{
+		const Entity entity = entityManager.addEntity();
+		entityManager.addComponent<TransformComponent>(entity)->x = i;
+		entityManager.addComponent<MovementComponent>(entity)->dx = 1;
+		entities.push_back(entity);
+	}
+	EXPECT_EQ(static_cast<size_t>(0), entityManager.getSequentialAccessHintsCount<TransformComponent>());
+	EXPECT_EQ(static_cast<size_t>(0), entityManager.getSequentialAccessHintsCount<MovementComponent>());
+
+	// every pool walked by a query gets one madvise(MADV_SEQUENTIAL) hint per query
+	entityManager.forEachComponentSet<TransformComponent, MovementComponent>([](TransformComponent* transform, MovementComponent* movement) {
+		transform->x += movement->dx;
+	});
+	EXPECT_EQ(static_cast<size_t>(1), entityManager.getSequentialAccessHintsCount<TransformComponent>());
+	EXPECT_EQ(static_cast<size_t>(1), entityManager.getSequentialAccessHintsCount<MovementComponent>());
+
+	std::vector<std::tuple<TransformComponent*>> components;
+	entityManager.getComponents<TransformComponent>(components);
+	EXPECT_EQ(static_cast<size_t>(2), entityManager.getSequentialAccessHintsCount<TransformComponent>());
+	EXPECT_EQ(static_cast<size_t>(1), entityManager.getSequentialAccessHintsCount<MovementComponent>());
+
+	// random access to single entities is not hinted as sequential
+	auto [transform] = entityManager.getEntityComponents<TransformComponent>(entities[50]);
+	ASSERT_NE(nullptr, transform);
+	EXPECT_EQ(51, transform->x);
+	EXPECT_EQ(static_cast<size_t>(2), entityManager.getSequentialAccessHintsCount<TransformComponent>());
+}
+
+TEST(EntityManager, MappedStorage_Checkpoint_SecondReaderSeesCheckpointedState)
+{
+	using namespace TestEntityManager_MappedStorage_Internal;
+
+	TemporaryDirectory directory("checkpoint");
+
+	ComponentFactory componentFactory;
+	RegisterComponents(componentFactory);
+
+	EntityManager entityManager(componentFactory, makeMappedOptions(directory.getPath(), RaccoonEcs::MappedStorageMode::CreateNew));
+	std::vector<Entity> entities;
+	for (int i = 0; i < 100; ++i)
+	{
+		const Entity entity = entityManager.addEntity();
+		entityManager.addComponent<TransformComponent>(entity)->x = i * 2;
+		entities.push_back(entity);
+	}
+	entityManager.removeEntity(entities[10]);
+
+	entityManager.checkpoint();
+
+	// changes made after the checkpoint are not part of the persisted entity table and counts yet
+	const Entity uncheckpointedEntity = entityManager.addEntity();
+	entityManager.addComponent<TransformComponent>(uncheckpointedEntity)->x = -1;
+
+	// the writer is still alive, so the reader can only see what checkpoint() has written to the files
+	EntityManager readerEntityManager(componentFactory, makeMappedOptions(directory.getPath(), RaccoonEcs::MappedStorageMode::OpenReadOnly));
+
+	EXPECT_FALSE(readerEntityManager.hasEntity(entities[10]));
+	EXPECT_FALSE(readerEntityManager.hasEntity(uncheckpointedEntity));
+	EXPECT_EQ(static_cast<size_t>(99), readerEntityManager.getMatchingEntitiesCount<TransformComponent>());
+	for (int i = 0; i < 100; ++i)
+	{
+		if (i == 10)
+		{
+			continue;
+		}
+		ASSERT_TRUE(readerEntityManager.hasEntity(entities[i]));
+		auto [transform] = readerEntityManager.getEntityComponents<TransformComponent>(entities[i]);
+		ASSERT_NE(nullptr, transform);
+		EXPECT_EQ(i * 2, transform->x);
+	}
+
+	// the next checkpoint makes the new entity visible to readers opened after it
+	entityManager.checkpoint();
+	EntityManager secondReaderEntityManager(componentFactory, makeMappedOptions(directory.getPath(), RaccoonEcs::MappedStorageMode::OpenReadOnly));
+	EXPECT_TRUE(secondReaderEntityManager.hasEntity(uncheckpointedEntity));
+	EXPECT_EQ(static_cast<size_t>(100), secondReaderEntityManager.getMatchingEntitiesCount<TransformComponent>());
+}
+
+TEST(EntityManager, MappedStorage_CloseAndReopen_DataIsRestored)
+{
+	using namespace TestEntityManager_MappedStorage_Internal;
+
+	TemporaryDirectory directory("reopen");
+
+	ComponentFactory componentFactory;
+	RegisterComponents(componentFactory);
+
+	std::vector<Entity> entities;
+	{
+		EntityManager entityManager(componentFactory, makeMappedOptions(directory.getPath(), RaccoonEcs::MappedStorageMode::CreateNew));
+		for (int i = 0; i < 100; ++i)
+		{
+			const Entity entity = entityManager.addEntity();
+			entityManager.addComponent<TransformComponent>(entity)->x = i * 2;
+			entities.push_back(entity);
+		}
+		entityManager.removeEntity(entities[10]);
+		// destroying the manager persists its state the same way checkpoint() does
+	}
+
+	EntityManager reopenedEntityManager(componentFactory, makeMappedOptions(directory.getPath(), RaccoonEcs::MappedStorageMode::OpenExisting));
+
+	EXPECT_FALSE(reopenedEntityManager.hasEntity(entities[10]));
+	EXPECT_EQ(static_cast<size_t>(99), reopenedEntityManager.getMatchingEntitiesCount<TransformComponent>());
+	for (int i = 0; i < 100; ++i)
+	{
+		if (i == 10)
+		{
+			continue;
+		}
+		ASSERT_TRUE(reopenedEntityManager.hasEntity(entities[i]));
+		auto [transform] = reopenedEntityManager.getEntityComponents<TransformComponent>(entities[i]);
+		ASSERT_NE(nullptr, transform);
+		EXPECT_EQ(i * 2, transform->x);
+	}
+
+	// entity versions are stored as well, so new entities don't collide with old ones
+	const Entity newEntity = reopenedEntityManager.addEntity();
+	EXPECT_NE(entities[10], newEntity);
+}
+
+TEST(EntityManager, MappedStorage_CloneIntoMemoryManager_ComponentsAreCopied)
+{
+	using namespace TestEntityManager_MappedStorage_Internal;
+
+	TemporaryDirectory directory("clone");
+
+	ComponentFactory componentFactory;
+	RegisterComponents(componentFactory);
+	EntityManager mappedEntityManager(componentFactory, makeMappedOptions(directory.getPath(), RaccoonEcs::MappedStorageMode::CreateNew));
+
+	const Entity entity = mappedEntityManager.addEntity();
+	mappedEntityManager.addComponent<TransformComponent>(entity)->y = 7;
+
+	EntityManager entityManager(componentFactory);
+	entityManager.overrideBy(mappedEntityManager);
+
+	auto [transform] = entityManager.getEntityComponents<TransformComponent>(entity);
+	ASSERT_NE(nullptr, transform);
+	EXPECT_EQ(7, transform->y);
+}
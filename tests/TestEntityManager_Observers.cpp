@@ -0,0 +1,241 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <span>
+#include <vector>
+
+#include "raccoon-ecs/delegates.h"
+#include "raccoon-ecs/entity_manager.h"
+
+#include "tests/utils/allocation_counter.h"
+
+namespace TestEntityManager_Observers_Internal
+{
+	enum ComponentType
+	{
+		TransformComponentId,
+		MovementComponentId,
+	};
+
+	using ComponentFactory = RaccoonEcs::ComponentFactoryImpl<ComponentType>;
+	using EntityManager = RaccoonEcs::EntityManagerImpl<ComponentType>;
+	using Entity = RaccoonEcs::Entity;
+
+	struct TransformComponent
+	{
+		int x;
+		int y;
+
+		static ComponentType GetTypeId() { return TransformComponentId; };
+	};
+
+	struct MovementComponent
+	{
+		int dx;
+		int dy;
+
+		static ComponentType GetTypeId() { return MovementComponentId; };
+	};
+
+	struct EntityManagerData
+	{
+		ComponentFactory componentFactory;
+		EntityManager entityManager{componentFactory};
+	};
+
+	static void RegisterComponents(ComponentFactory& inOutFactory)
+	{
+		inOutFactory.registerComponent<TransformComponent>();
+		inOutFactory.registerComponent<MovementComponent>();
+	}
+
+	static std::unique_ptr<EntityManagerData> PrepareEntityManager()
+	{
+		auto data = std::make_unique<EntityManagerData>();
+		RegisterComponents(data->componentFactory);
+		return data;
+	}
+
+	struct ObservedBatches
+	{
+		std::vector<std::vector<Entity>> batches;
+
+		void bindTo(RaccoonEcs::MulticastDelegate<std::span<const Entity>>& delegate)
+		{
+			delegate.bind([this](std::span<const Entity> entities) {
+				batches.emplace_back(entities.begin(), entities.end());
+				std::sort(batches.back().begin(), batches.back().end());
+			});
+		}
+	};
+} // namespace EntityManagerTestInternals
+
+TEST(EntityManager, ComponentAddedObserver_AddComponents_BatchIsDeliveredOnFlush)
+{
+	using namespace TestEntityManager_Observers_Internal;
+
+	auto entityManagerData = PrepareEntityManager();
+	EntityManager& entityManager = entityManagerData->entityManager;
+
+	ObservedBatches addedTransforms;
+	addedTransforms.bindTo(entityManager.onComponentsAdded<TransformComponent>());
+
+	std::vector<Entity> entities;
+	for (int i = 0; i < 3; ++i)
+	{
+		const Entity entity = entityManager.addEntity();
+		entityManager.addComponent<TransformComponent>(entity);
+		entityManager.addComponent<MovementComponent>(entity);
+		entities.push_back(entity);
+	}
+
+	EXPECT_TRUE(addedTransforms.batches.empty());
+
+	entityManager.flushComponentObservers();
+
+	ASSERT_EQ(static_cast<size_t>(1), addedTransforms.batches.size());
+	std::sort(entities.begin(), entities.end());
+	EXPECT_EQ(entities, addedTransforms.batches[0]);
+
+	// the batch is delivered only once
+	entityManager.flushComponentObservers();
+	EXPECT_EQ(static_cast<size_t>(1), addedTransforms.batches.size());
+}
+
+TEST(EntityManager, ComponentRemovedObserver_RemoveComponentsAndEntities_BatchIsDeliveredOnFlush)
+{
+	using namespace TestEntityManager_Observers_Internal;
+
+	auto entityManagerData = PrepareEntityManager();
+	EntityManager& entityManager = entityManagerData->entityManager;
+
+	const Entity entity1 = entityManager.addEntity();
+	entityManager.addComponent<TransformComponent>(entity1);
+	const Entity entity2 = entityManager.addEntity();
+	entityManager.addComponent<TransformComponent>(entity2);
+	const Entity entity3 = entityManager.addEntity();
+	entityManager.addComponent<MovementComponent>(entity3);
+
+	ObservedBatches removedTransforms;
+	removedTransforms.bindTo(entityManager.onComponentsRemoved<TransformComponent>());
+	entityManager.flushComponentObservers();
+	EXPECT_TRUE(removedTransforms.batches.empty());
+
+	entityManager.removeComponent<TransformComponent>(entity1);
+	entityManager.removeEntity(entity2);
+	// entity without the observed component is not reported
+	entityManager.removeEntity(entity3);
+
+	EXPECT_TRUE(removedTransforms.batches.empty());
+
+	entityManager.flushComponentObservers();
+
+	std::vector<Entity> expectedEntities{entity1, entity2};
+	std::sort(expectedEntities.begin(), expectedEntities.end());
+	ASSERT_EQ(static_cast<size_t>(1), removedTransforms.batches.size());
+	EXPECT_EQ(expectedEntities, removedTransforms.batches[0]);
+}
+
+TEST(EntityManager, ComponentObservers_ExecuteScheduledActions_BatchesAreDelivered)
+{
+	using namespace TestEntityManager_Observers_Internal;
+
+	auto entityManagerData = PrepareEntityManager();
+	EntityManager& entityManager = entityManagerData->entityManager;
+
+	const Entity entity = entityManager.addEntity();
+	entityManager.addComponent<MovementComponent>(entity);
+
+	ObservedBatches addedTransforms;
+	addedTransforms.bindTo(entityManager.onComponentsAdded<TransformComponent>());
+	ObservedBatches removedMovements;
+	removedMovements.bindTo(entityManager.onComponentsRemoved<MovementComponent>());
+
+	entityManager.scheduleAddComponent<TransformComponent>(entity);
+	entityManager.scheduleRemoveComponent<MovementComponent>(entity);
+
+	EXPECT_TRUE(addedTransforms.batches.empty());
+	EXPECT_TRUE(removedMovements.batches.empty());
+
+	entityManager.executeScheduledActions();
+
+	ASSERT_EQ(static_cast<size_t>(1), addedTransforms.batches.size());
+	EXPECT_EQ(std::vector<Entity>{entity}, addedTransforms.batches[0]);
+	ASSERT_EQ(static_cast<size_t>(1), removedMovements.batches.size());
+	EXPECT_EQ(std::vector<Entity>{entity}, removedMovements.batches[0]);
+}
+
+TEST(EntityManager, ComponentObservers_ObserverBoundToAnotherType_NothingIsDelivered)
+{
+	using namespace TestEntityManager_Observers_Internal;
+
+	auto entityManagerData = PrepareEntityManager();
+	EntityManager& entityManager = entityManagerData->entityManager;
+
+	ObservedBatches addedMovements;
+	addedMovements.bindTo(entityManager.onComponentsAdded<MovementComponent>());
+
+	const Entity entity = entityManager.addEntity();
+	entityManager.addComponent<TransformComponent>(entity);
+	entityManager.removeEntity(entity);
+	entityManager.flushComponentObservers();
+
+	EXPECT_TRUE(addedMovements.batches.empty());
+}
+
+TEST(EntityManager, ComponentObservers_MultipleObserversBound_AllReceiveSameBatch)
+{
+	using namespace TestEntityManager_Observers_Internal;
+
+	auto entityManagerData = PrepareEntityManager();
+	EntityManager& entityManager = entityManagerData->entityManager;
+
+	ObservedBatches observer1;
+	observer1.bindTo(entityManager.onComponentsAdded<TransformComponent>());
+	ObservedBatches observer2;
+	observer2.bindTo(entityManager.onComponentsAdded<TransformComponent>());
+
+	const Entity entity = entityManager.addEntity();
+	entityManager.addComponent<TransformComponent>(entity);
+	entityManager.flushComponentObservers();
+
+	ASSERT_EQ(static_cast<size_t>(1), observer1.batches.size());
+	ASSERT_EQ(static_cast<size_t>(1), observer2.batches.size());
+	EXPECT_EQ(observer1.batches[0], observer2.batches[0]);
+}
+
+TEST(EntityManager, ComponentObservers_NoObserversBound_NothingIsAllocated)
+{
+	using namespace TestEntityManager_Observers_Internal;
+
+	auto entityManagerData = PrepareEntityManager();
+	EntityManager& entityManager = entityManagerData->entityManager;
+
+	std::vector<Entity> entities;
+	for (int i = 0; i < 100; ++i)
+	{
+		entities.push_back(entityManager.addEntity());
+	}
+
+	const auto runFrame = [&entityManager, &entities]() {
+		for (const Entity entity : entities)
+		{
+			entityManager.addComponent<TransformComponent>(entity);
+		}
+		for (const Entity entity : entities)
+		{
+			entityManager.removeComponent<TransformComponent>(entity);
+		}
+		// batches would be delivered here, with nothing bound nothing is collected for them
+		entityManager.executeScheduledActions();
+		// the Added/Removed change logs are trimmed every frame, so they keep reusing their memory
+		entityManager.trimStructuralChangeLogs(entityManager.advanceTick());
+	};
+
+	// the first frame grows the pool to its working size
+	runFrame();
+
+	AllocationCounter::ScopedAllocationCounter counter;
+	runFrame();
+	EXPECT_EQ(static_cast<size_t>(0), counter.getAllocationsCount());
+}
@@ -0,0 +1,291 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+#include "raccoon-ecs/entity_manager.h"
+
+namespace TestEntityManager_QueryPlanning_Internal
+{
+	enum ComponentType
+	{
+		EmptyComponentId,
+		TransformComponentId,
+		MovementComponentId,
+	};
+
+	using ComponentFactory = RaccoonEcs::ComponentFactoryImpl<ComponentType>;
+	using EntityManager = RaccoonEcs::EntityManagerImpl<ComponentType>;
+	using Entity = RaccoonEcs::Entity;
+
+	struct EmptyComponent
+	{
+		static ComponentType GetTypeId() { return EmptyComponentId; };
+	};
+
+	struct TransformComponent
+	{
+		int x;
+		int y;
+
+		static ComponentType GetTypeId() { return TransformComponentId; };
+	};
+
+	struct MovementComponent
+	{
+		int dx;
+		int dy;
+
+		static ComponentType GetTypeId() { return MovementComponentId; };
+	};
+
+	struct EntityManagerData
+	{
+		ComponentFactory componentFactory;
+		EntityManager entityManager{componentFactory};
+	};
+
+	static void RegisterComponents(ComponentFactory& inOutFactory)
+	{
+		inOutFactory.registerComponent<EmptyComponent>();
+		inOutFactory.registerComponent<TransformComponent>();
+		inOutFactory.registerComponent<MovementComponent>();
+	}
+
+	static std::unique_ptr<EntityManagerData> PrepareEntityManager()
+	{
+		auto data = std::make_unique<EntityManagerData>();
+		RegisterComponents(data->componentFactory);
+		return data;
+	}
+
+	// every entity has TransformComponent and every hundredth entity also has EmptyComponent
+	static std::vector<Entity> fillSkewedEntities(EntityManager& entityManager, int entitiesCount)
+	{
+		std::vector<Entity> entitiesWithRareComponent;
+		for (int i = 0; i < entitiesCount; ++i)
+		{
+			const Entity entity = entityManager.addEntity();
+			entityManager.addComponent<TransformComponent>(entity);
+			if (i % 100 == 0)
+			{
+				entityManager.addComponent<EmptyComponent>(entity);
+				entitiesWithRareComponent.push_back(entity);
+			}
+		}
+		return entitiesWithRareComponent;
+	}
+} // namespace EntityManagerTestInternals
+
+TEST(EntityManager, QueryWithSkewedComponentCounts_GetQueryPlan_SmallestPoolDrivesIterationForAnyArgumentOrder)
+{
+	using namespace TestEntityManager_QueryPlanning_Internal;
+
+	auto entityManagerData = PrepareEntityManager();
+	EntityManager& entityManager = entityManagerData->entityManager;
+	fillSkewedEntities(entityManager, 1000);
+
+	{
+		const EntityManager::QueryPlan plan = entityManager.getQueryPlan<EmptyComponent, TransformComponent>();
+		EXPECT_EQ(EmptyComponentId, plan.drivingComponentType);
+		EXPECT_FALSE(plan.isUsingIndex);
+	}
+
+	{
+		const EntityManager::QueryPlan plan = entityManager.getQueryPlan<TransformComponent, EmptyComponent>();
+		EXPECT_EQ(EmptyComponentId, plan.drivingComponentType);
+		EXPECT_FALSE(plan.isUsingIndex);
+	}
+}
+
+TEST(EntityManager, QueryWithSkewedComponentCounts_IterateInAnyArgumentOrder_SameEntitiesAreVisited)
+{
+	using namespace TestEntityManager_QueryPlanning_Internal;
+
+	auto entityManagerData = PrepareEntityManager();
+	EntityManager& entityManager = entityManagerData->entityManager;
+	std::vector<Entity> expectedEntities = fillSkewedEntities(entityManager, 1000);
+	std::sort(expectedEntities.begin(), expectedEntities.end());
+
+	{
+		std::vector<Entity> visitedEntities;
+		entityManager.forEachComponentSetWithEntity<EmptyComponent, TransformComponent>(
+			[&visitedEntities](Entity entity, EmptyComponent*, TransformComponent*) {
+				visitedEntities.push_back(entity);
+			}
+		);
+		std::sort(visitedEntities.begin(), visitedEntities.end());
+		EXPECT_EQ(expectedEntities, visitedEntities);
+	}
+
+	{
+		std::vector<Entity> visitedEntities;
+		entityManager.forEachComponentSetWithEntity<TransformComponent, EmptyComponent>(
+			[&visitedEntities](Entity entity, TransformComponent*, EmptyComponent*) {
+				visitedEntities.push_back(entity);
+			}
+		);
+		std::sort(visitedEntities.begin(), visitedEntities.end());
+		EXPECT_EQ(expectedEntities, visitedEntities);
+	}
+}
+
+TEST(EntityManager, QueryWithChangingComponentCounts_GetQueryPlan_PlanFollowsLiveCounts)
+{
+	using namespace TestEntityManager_QueryPlanning_Internal;
+
+	auto entityManagerData = PrepareEntityManager();
+	EntityManager& entityManager = entityManagerData->entityManager;
+
+	std::vector<Entity> entities;
+	for (int i = 0; i < 10; ++i)
+	{
+		const Entity entity = entityManager.addEntity();
+		entityManager.addComponent<TransformComponent>(entity);
+		entities.push_back(entity);
+	}
+	entityManager.addComponent<MovementComponent>(entities[0]);
+
+	EXPECT_EQ(MovementComponentId, (entityManager.getQueryPlan<TransformComponent, MovementComponent>().drivingComponentType));
+
+	for (int i = 0; i < 40; ++i)
+	{
+		const Entity entity = entityManager.addEntity();
+		entityManager.addComponent<MovementComponent>(entity);
+	}
+	for (size_t i = 1; i < entities.size(); ++i)
+	{
+		entityManager.removeComponent<TransformComponent>(entities[i]);
+	}
+
+	EXPECT_EQ(TransformComponentId, (entityManager.getQueryPlan<TransformComponent, MovementComponent>().drivingComponentType));
+
+	int iterationsCount = 0;
+	entityManager.forEachComponentSet<TransformComponent, MovementComponent>([&iterationsCount](TransformComponent*, MovementComponent*) {
+		++iterationsCount;
+	});
+	EXPECT_EQ(1, iterationsCount);
+}
+
+TEST(EntityManager, QueryWithChangingComponentCounts_GetQueryPlan_PlanIsCachedUntilCountsInvert)
+{
+	using namespace TestEntityManager_QueryPlanning_Internal;
+
+	auto entityManagerData = PrepareEntityManager();
+	EntityManager& entityManager = entityManagerData->entityManager;
+
+	std::vector<Entity> entities;
+	for (int i = 0; i < 10; ++i)
+	{
+		const Entity entity = entityManager.addEntity();
+		entityManager.addComponent<TransformComponent>(entity);
+		entities.push_back(entity);
+	}
+	entityManager.addComponent<MovementComponent>(entities[0]);
+
+	const EntityManager::QueryPlan firstPlan = entityManager.getQueryPlan<TransformComponent, MovementComponent>();
+	EXPECT_EQ(MovementComponentId, firstPlan.drivingComponentType);
+
+	// the plan is built once per tuple type and reused by the following queries
+	entityManager.forEachComponentSet<TransformComponent, MovementComponent>([](TransformComponent*, MovementComponent*) {});
+	entityManager.forEachComponentSet<TransformComponent, MovementComponent>([](TransformComponent*, MovementComponent*) {});
+	{
+		const EntityManager::QueryPlan plan = entityManager.getQueryPlan<TransformComponent, MovementComponent>();
+		EXPECT_EQ(MovementComponentId, plan.drivingComponentType);
+		EXPECT_EQ(firstPlan.planRevision, plan.planRevision);
+	}
+
+	// counts change but MovementComponent is still the rarer one, so the cached plan stays
+	for (int i = 0; i < 5; ++i)
+	{
+		const Entity entity = entityManager.addEntity();
+		entityManager.addComponent<MovementComponent>(entity);
+	}
+	{
+		const EntityManager::QueryPlan plan = entityManager.getQueryPlan<TransformComponent, MovementComponent>();
+		EXPECT_EQ(MovementComponentId, plan.drivingComponentType);
+		EXPECT_EQ(firstPlan.planRevision, plan.planRevision);
+	}
+
+	// the counts invert and the plan is picked again
+	for (size_t i = 1; i < entities.size(); ++i)
+	{
+		entityManager.removeComponent<TransformComponent>(entities[i]);
+	}
+	const EntityManager::QueryPlan replannedPlan = entityManager.getQueryPlan<TransformComponent, MovementComponent>();
+	EXPECT_EQ(TransformComponentId, replannedPlan.drivingComponentType);
+	EXPECT_NE(firstPlan.planRevision, replannedPlan.planRevision);
+
+	entityManager.forEachComponentSet<TransformComponent, MovementComponent>([](TransformComponent*, MovementComponent*) {});
+	EXPECT_EQ(replannedPlan.planRevision, (entityManager.getQueryPlan<TransformComponent, MovementComponent>().planRevision));
+}
+
+TEST(EntityManager, QueryWithIndex_GetQueryPlan_IndexIsUsed)
+{
+	using namespace TestEntityManager_QueryPlanning_Internal;
+
+	auto entityManagerData = PrepareEntityManager();
+	EntityManager& entityManager = entityManagerData->entityManager;
+	fillSkewedEntities(entityManager, 1000);
+
+	entityManager.initIndex<TransformComponent, EmptyComponent>();
+
+	{
+		const EntityManager::QueryPlan plan = entityManager.getQueryPlan<EmptyComponent, TransformComponent>();
+		EXPECT_TRUE(plan.isUsingIndex);
+	}
+
+	{
+		const EntityManager::QueryPlan plan = entityManager.getQueryPlan<TransformComponent, EmptyComponent>();
+		EXPECT_TRUE(plan.isUsingIndex);
+	}
+
+	int iterationsCount = 0;
+	entityManager.forEachComponentSet<EmptyComponent, TransformComponent>([&iterationsCount](EmptyComponent*, TransformComponent*) {
+		++iterationsCount;
+	});
+	EXPECT_EQ(10, iterationsCount);
+}
+
+// benchmark, run with --gtest_also_run_disabled_tests
+// 1% of entities have the rare component, iterating in both argument orders should take about the same time
+TEST(EntityManager, DISABLED_Benchmark_QueryWithSkewedComponentCounts_IterateInBothArgumentOrders)
+{
+	using namespace TestEntityManager_QueryPlanning_Internal;
+
+	constexpr int entitiesCount = 1000000;
+	constexpr int passesCount = 100;
+
+	auto entityManagerData = PrepareEntityManager();
+	EntityManager& entityManager = entityManagerData->entityManager;
+	fillSkewedEntities(entityManager, entitiesCount);
+
+	int rareFirstIterationsCount = 0;
+	const auto rareFirstStartTime = std::chrono::steady_clock::now();
+	for (int pass = 0; pass < passesCount; ++pass)
+	{
+		entityManager.forEachComponentSet<EmptyComponent, TransformComponent>([&rareFirstIterationsCount](EmptyComponent*, TransformComponent*) {
+			++rareFirstIterationsCount;
+		});
+	}
+	const auto rareFirstTime = std::chrono::steady_clock::now() - rareFirstStartTime;
+
+	int rareLastIterationsCount = 0;
+	const auto rareLastStartTime = std::chrono::steady_clock::now();
+	for (int pass = 0; pass < passesCount; ++pass)
+	{
+		entityManager.forEachComponentSet<TransformComponent, EmptyComponent>([&rareLastIterationsCount](TransformComponent*, EmptyComponent*) {
+			++rareLastIterationsCount;
+		});
+	}
+	const auto rareLastTime = std::chrono::steady_clock::now() - rareLastStartTime;
+
+	EXPECT_EQ(rareFirstIterationsCount, rareLastIterationsCount);
+
+	std::cout << entitiesCount << " entities, 1% with the rare component, " << passesCount << " passes"
+		<< ", <EmptyComponent, TransformComponent>: " << std::chrono::duration_cast<std::chrono::microseconds>(rareFirstTime).count() << " us"
+		<< ", <TransformComponent, EmptyComponent>: " << std::chrono::duration_cast<std::chrono::microseconds>(rareLastTime).count() << " us"
+		<< std::endl;
+}
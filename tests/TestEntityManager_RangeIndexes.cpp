@@ -0,0 +1,234 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "raccoon-ecs/entity_manager.h"
+
+namespace TestEntityManager_RangeIndexes_Internal
+{
+	enum ComponentType
+	{
+		ComponentTypeA,
+		ComponentTypeB,
+	};
+
+	using ComponentFactory = RaccoonEcs::ComponentFactoryImpl<ComponentType>;
+	using EntityManager = RaccoonEcs::EntityManagerImpl<ComponentType>;
+	using Entity = RaccoonEcs::Entity;
+
+	struct ComponentA
+	{
+		int value;
+
+		static ComponentType GetTypeId() { return ComponentTypeA; };
+	};
+
+	struct ComponentB
+	{
+		int value;
+
+		static ComponentType GetTypeId() { return ComponentTypeB; };
+	};
+
+	struct EntityManagerData
+	{
+		ComponentFactory componentFactory;
+		EntityManager entityManager{componentFactory};
+	};
+
+	static void RegisterComponents(ComponentFactory& inOutFactory)
+	{
+		inOutFactory.registerComponent<ComponentA>();
+		inOutFactory.registerComponent<ComponentB>();
+	}
+
+	static std::unique_ptr<EntityManagerData> PrepareEntityManager()
+	{
+		auto data = std::make_unique<EntityManagerData>();
+		RegisterComponents(data->componentFactory);
+		return data;
+	}
+
+	static std::vector<Entity> addEntitiesWithValues(EntityManager& entityManager, const std::vector<int>& values)
+	{
+		std::vector<Entity> result;
+		for (int value : values)
+		{
+			const Entity entity = entityManager.addEntity();
+			entityManager.addComponent<ComponentA>(entity)->value = value;
+			result.push_back(entity);
+		}
+		return result;
+	}
+
+	static void checkEntitiesInRange(EntityManager& entityManager, int minValue, int maxValue, std::vector<Entity> expectedEntities)
+	{
+		std::vector<Entity> entities;
+		entityManager.getEntitiesInRange<ComponentA>(minValue, maxValue, entities);
+		std::sort(entities.begin(), entities.end());
+		std::sort(expectedEntities.begin(), expectedEntities.end());
+		EXPECT_EQ(expectedEntities, entities);
+	}
+} // namespace EntityManagerTestInternals
+
+TEST(EntityManager, EntityManagerWithRangeIndex_GetEntitiesInRange_ReturnsOnlyEntitiesInRange)
+{
+	using namespace TestEntityManager_RangeIndexes_Internal;
+
+	auto entityManagerData = PrepareEntityManager();
+	EntityManager& entityManager = entityManagerData->entityManager;
+
+	const std::vector<Entity> entities = addEntitiesWithValues(entityManager, {50, 100, 300, 500, 700});
+	entityManager.initRangeIndex<ComponentA>(&ComponentA::value);
+
+	// range bounds are inclusive
+	checkEntitiesInRange(entityManager, 100, 500, {entities[1], entities[2], entities[3]});
+	checkEntitiesInRange(entityManager, 0, 49, {});
+	checkEntitiesInRange(entityManager, 701, 1000, {});
+	checkEntitiesInRange(entityManager, 0, 1000, entities);
+}
+
+TEST(EntityManager, EntityManagerWithRangeIndex_GetEntitiesInRange_ReturnsEntitiesSortedByValue)
+{
+	using namespace TestEntityManager_RangeIndexes_Internal;
+
+	auto entityManagerData = PrepareEntityManager();
+	EntityManager& entityManager = entityManagerData->entityManager;
+
+	entityManager.initRangeIndex<ComponentA>(&ComponentA::value);
+	const std::vector<Entity> entities = addEntitiesWithValues(entityManager, {400, 200, 300, 100});
+
+	std::vector<Entity> result;
+	entityManager.getEntitiesInRange<ComponentA>(150, 1000, result);
+	EXPECT_EQ(std::vector<Entity>({entities[1], entities[2], entities[0]}), result);
+}
+
+TEST(EntityManager, EntityManagerWithRangeIndex_GetEntitiesWithTopValues_ReturnsEntitiesWithHighestValues)
+{
+	using namespace TestEntityManager_RangeIndexes_Internal;
+
+	auto entityManagerData = PrepareEntityManager();
+	EntityManager& entityManager = entityManagerData->entityManager;
+
+	entityManager.initRangeIndex<ComponentA>(&ComponentA::value);
+	const std::vector<Entity> entities = addEntitiesWithValues(entityManager, {10, 60, 30, 50, 20, 40});
+
+	{
+		std::vector<Entity> result;
+		entityManager.getEntitiesWithTopValues<ComponentA>(3, result);
+		EXPECT_EQ(std::vector<Entity>({entities[1], entities[3], entities[5]}), result);
+	}
+
+	{
+		std::vector<Entity> result;
+		entityManager.getEntitiesWithTopValues<ComponentA>(10, result);
+		EXPECT_EQ(static_cast<size_t>(6), result.size());
+	}
+}
+
+TEST(EntityManager, EntityManagerWithRangeIndex_AddAndRemoveComponents_IndexIsUpdated)
+{
+	using namespace TestEntityManager_RangeIndexes_Internal;
+
+	auto entityManagerData = PrepareEntityManager();
+	EntityManager& entityManager = entityManagerData->entityManager;
+
+	entityManager.initRangeIndex<ComponentA>(&ComponentA::value);
+	const std::vector<Entity> entities = addEntitiesWithValues(entityManager, {100, 200, 300});
+
+	const Entity entityWithoutComponent = entityManager.addEntity();
+	entityManager.addComponent<ComponentB>(entityWithoutComponent)->value = 250;
+
+	checkEntitiesInRange(entityManager, 150, 350, {entities[1], entities[2]});
+
+	entityManager.removeComponent<ComponentA>(entities[1]);
+	checkEntitiesInRange(entityManager, 150, 350, {entities[2]});
+
+	entityManager.removeEntity(entities[2]);
+	checkEntitiesInRange(entityManager, 150, 350, {});
+	checkEntitiesInRange(entityManager, 0, 1000, {entities[0]});
+}
+
+TEST(EntityManager, EntityManagerWithRangeIndex_FillValueAfterAddComponent_ValueIsIndexedOnNextQuery)
+{
+	using namespace TestEntityManager_RangeIndexes_Internal;
+
+	auto entityManagerData = PrepareEntityManager();
+	EntityManager& entityManager = entityManagerData->entityManager;
+
+	entityManager.initRangeIndex<ComponentA>(&ComponentA::value);
+
+	// addComponent only queues the new component for indexing, its value is read by the next query,
+	// so the usual addComponent(entity)->value = x pattern doesn't need modifyComponent
+	const Entity entity1 = entityManager.addEntity();
+	ComponentA* component1 = entityManager.addComponent<ComponentA>(entity1);
+	component1->value = 100;
+	const Entity entity2 = entityManager.addEntity();
+	entityManager.addComponent<ComponentA>(entity2)->value = 200;
+
+	checkEntitiesInRange(entityManager, 50, 150, {entity1});
+	checkEntitiesInRange(entityManager, 150, 250, {entity2});
+
+	// once indexed, direct writes are not tracked anymore and modifyComponent has to be used
+	entityManager.modifyComponent<ComponentA>(entity1, [](ComponentA* component) {
+		component->value = 300;
+	});
+	checkEntitiesInRange(entityManager, 250, 350, {entity1});
+}
+
+TEST(EntityManager, EntityManagerWithRangeIndex_ModifyComponent_IndexIsUpdated)
+{
+	using namespace TestEntityManager_RangeIndexes_Internal;
+
+	auto entityManagerData = PrepareEntityManager();
+	EntityManager& entityManager = entityManagerData->entityManager;
+
+	const std::vector<Entity> entities = addEntitiesWithValues(entityManager, {100, 200, 300});
+	entityManager.initRangeIndex<ComponentA>(&ComponentA::value);
+
+	entityManager.modifyComponent<ComponentA>(entities[0], [](ComponentA* component) {
+		component->value = 1000;
+	});
+
+	checkEntitiesInRange(entityManager, 0, 500, {entities[1], entities[2]});
+	checkEntitiesInRange(entityManager, 900, 1100, {entities[0]});
+
+	std::vector<Entity> result;
+	entityManager.getEntitiesWithTopValues<ComponentA>(1, result);
+	EXPECT_EQ(std::vector<Entity>({entities[0]}), result);
+}
+
+TEST(EntityManager, EntityManagerWithRangeIndex_ScheduleAddComponent_IndexIsUpdatedAfterExecution)
+{
+	using namespace TestEntityManager_RangeIndexes_Internal;
+
+	auto entityManagerData = PrepareEntityManager();
+	EntityManager& entityManager = entityManagerData->entityManager;
+
+	entityManager.initRangeIndex<ComponentA>(&ComponentA::value);
+	const Entity entity = entityManager.addEntity();
+	entityManager.scheduleAddComponent<ComponentA>(entity)->value = 150;
+
+	checkEntitiesInRange(entityManager, 100, 200, {});
+
+	entityManager.executeScheduledActions();
+
+	checkEntitiesInRange(entityManager, 100, 200, {entity});
+}
+
+TEST(EntityManager, EntityManagerWithRangeIndex_CloneEntityManager_IndexIsCopied)
+{
+	using namespace TestEntityManager_RangeIndexes_Internal;
+
+	auto entityManagerData = PrepareEntityManager();
+	EntityManager& entityManager = entityManagerData->entityManager;
+
+	entityManager.initRangeIndex<ComponentA>(&ComponentA::value);
+	const std::vector<Entity> entities = addEntitiesWithValues(entityManager, {100, 200, 300});
+
+	EntityManager entityManagerCopy(entityManagerData->componentFactory);
+	entityManagerCopy.overrideBy(entityManager);
+
+	checkEntitiesInRange(entityManagerCopy, 150, 350, {entities[1], entities[2]});
+}
@@ -0,0 +1,331 @@
+#include <gtest/gtest.h>
+
+#include <span>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "raccoon-ecs/entity_manager.h"
+#include "raccoon-ecs/error_handling.h"
+
+#include "tests/utils/allocation_counter.h"
+
+namespace TestEntityManager_RealTime_Internal
+{
+	enum ComponentType
+	{
+		TransformComponentId,
+		MovementComponentId,
+	};
+
+	using ComponentFactory = RaccoonEcs::ComponentFactoryImpl<ComponentType>;
+	using EntityManager = RaccoonEcs::EntityManagerImpl<ComponentType>;
+	using Entity = RaccoonEcs::Entity;
+	using ScopedAllocationCounter = AllocationCounter::ScopedAllocationCounter;
+
+	struct TransformComponent
+	{
+		int x;
+		int y;
+
+		static ComponentType GetTypeId() { return TransformComponentId; };
+	};
+
+	struct MovementComponent
+	{
+		int dx;
+		int dy;
+
+		static ComponentType GetTypeId() { return MovementComponentId; };
+	};
+
+	struct EntityManagerData
+	{
+		ComponentFactory componentFactory;
+		EntityManager entityManager{componentFactory};
+	};
+
+	static void RegisterComponents(ComponentFactory& inOutFactory)
+	{
+		inOutFactory.registerComponent<TransformComponent>();
+		inOutFactory.registerComponent<MovementComponent>();
+	}
+
+	struct FrozenCapacities
+	{
+		explicit FrozenCapacities(size_t capacity)
+			: entities(capacity)
+			, transforms(capacity)
+			, movements(capacity)
+			, indexedEntities(capacity)
+			, scheduledActions(capacity)
+		{}
+
+		size_t entities;
+		size_t transforms;
+		size_t movements;
+		size_t indexedEntities;
+		size_t scheduledActions;
+	};
+
+	static std::unique_ptr<EntityManagerData> PrepareFrozenEntityManager(const FrozenCapacities& capacities)
+	{
+		auto data = std::make_unique<EntityManagerData>();
+		RegisterComponents(data->componentFactory);
+		EntityManager& entityManager = data->entityManager;
+		entityManager.initIndex<TransformComponent, MovementComponent>();
+		entityManager.reserveIndex<TransformComponent, MovementComponent>(capacities.indexedEntities);
+		entityManager.reserveEntities(capacities.entities);
+		entityManager.reserveComponents<TransformComponent>(capacities.transforms);
+		entityManager.reserveComponents<MovementComponent>(capacities.movements);
+		entityManager.reserveScheduledActions(capacities.scheduledActions);
+		entityManager.freeze();
+		return data;
+	}
+
+	static std::unique_ptr<EntityManagerData> PrepareFrozenEntityManager(size_t capacity)
+	{
+		return PrepareFrozenEntityManager(FrozenCapacities(capacity));
+	}
+
+	static int gReportedErrorsCount = 0;
+
+	// counts errors reported through gErrorHandler during the lifetime of the object
+	class ScopedReportedErrorsCounter
+	{
+	public:
+		ScopedReportedErrorsCounter()
+			: mPreviousErrorHandler(RaccoonEcs::gErrorHandler)
+		{
+			gReportedErrorsCount = 0;
+			RaccoonEcs::gErrorHandler = [](const std::string&) { ++gReportedErrorsCount; };
+		}
+
+		~ScopedReportedErrorsCounter()
+		{
+			RaccoonEcs::gErrorHandler = mPreviousErrorHandler;
+		}
+
+		ScopedReportedErrorsCounter(const ScopedReportedErrorsCounter&) = delete;
+		ScopedReportedErrorsCounter& operator=(const ScopedReportedErrorsCounter&) = delete;
+
+	private:
+		decltype(RaccoonEcs::gErrorHandler) mPreviousErrorHandler;
+	};
+} // namespace EntityManagerTestInternals
+
+TEST(EntityManager, FrozenEntityManager_AddAndRemoveWithinCapacity_NothingIsAllocated)
+{
+	using namespace TestEntityManager_RealTime_Internal;
+
+	auto entityManagerData = PrepareFrozenEntityManager(100);
+	EntityManager& entityManager = entityManagerData->entityManager;
+	EXPECT_TRUE(entityManager.isFrozen());
+
+	std::vector<Entity> entities;
+	entities.reserve(100);
+	std::vector<std::tuple<TransformComponent*, MovementComponent*>> components;
+	components.reserve(100);
+
+	ScopedAllocationCounter counter;
+
+	for (int i = 0; i < 100; ++i)
+	{
+		const Entity entity = entityManager.addEntity();
+		entityManager.addComponent<TransformComponent>(entity)->x = i;
+		entityManager.addComponent<MovementComponent>(entity)->dx = 1;
+		entities.push_back(entity);
+	}
+
+	entityManager.forEachComponentSet<TransformComponent, MovementComponent>([](TransformComponent* transform, MovementComponent* movement) {
+		transform->x += movement->dx;
+	});
+	entityManager.getComponents<TransformComponent, MovementComponent>(components);
+
+	for (int i = 0; i < 50; ++i)
+	{
+		entityManager.removeEntity(entities[i]);
+	}
+	for (int i = 0; i < 50; ++i)
+	{
+		const Entity entity = entityManager.addEntity();
+		entityManager.addComponent<TransformComponent>(entity);
+	}
+
+	EXPECT_EQ(static_cast<size_t>(0), counter.getAllocationsCount());
+	EXPECT_EQ(static_cast<size_t>(100), components.size());
+}
+
+TEST(EntityManager, FrozenEntityManager_ScheduledActionsWithinCapacity_NothingIsAllocated)
+{
+	using namespace TestEntityManager_RealTime_Internal;
+
+	auto entityManagerData = PrepareFrozenEntityManager(50);
+	EntityManager& entityManager = entityManagerData->entityManager;
+
+	std::vector<Entity> entities;
+	entities.reserve(50);
+	for (int i = 0; i < 50; ++i)
+	{
+		entities.push_back(entityManager.addEntity());
+	}
+
+	ScopedAllocationCounter counter;
+
+	for (const Entity entity : entities)
+	{
+		entityManager.scheduleAddComponent<TransformComponent>(entity);
+	}
+	entityManager.executeScheduledActions();
+
+	for (const Entity entity : entities)
+	{
+		entityManager.scheduleRemoveComponent<TransformComponent>(entity);
+	}
+	entityManager.executeScheduledActions();
+
+	EXPECT_EQ(static_cast<size_t>(0), counter.getAllocationsCount());
+}
+
+#ifdef RACCOON_ECS_DEBUG_CHECKS_ENABLED
+TEST(EntityManager, FrozenEntityManager_ExceedEntitiesCapacity_ErrorIsReported)
+{
+	using namespace TestEntityManager_RealTime_Internal;
+
+	FrozenCapacities capacities(10);
+	auto entityManagerData = PrepareFrozenEntityManager(capacities);
+	EntityManager& entityManager = entityManagerData->entityManager;
+
+	for (size_t i = 0; i < capacities.entities; ++i)
+	{
+		entityManager.addEntity();
+	}
+
+	ScopedReportedErrorsCounter errorsCounter;
+
+	// the entity table has to grow, which is not allowed after freeze()
+	entityManager.addEntity();
+	EXPECT_EQ(1, gReportedErrorsCount);
+}
+
+TEST(EntityManager, FrozenEntityManager_ExceedComponentsCapacity_ErrorIsReported)
+{
+	using namespace TestEntityManager_RealTime_Internal;
+
+	// room for one more entity, so only the component pool has to grow
+	FrozenCapacities capacities(10);
+	capacities.entities = 11;
+	auto entityManagerData = PrepareFrozenEntityManager(capacities);
+	EntityManager& entityManager = entityManagerData->entityManager;
+
+	for (int i = 0; i < 10; ++i)
+	{
+		const Entity entity = entityManager.addEntity();
+		entityManager.addComponent<TransformComponent>(entity);
+	}
+
+	ScopedReportedErrorsCounter errorsCounter;
+
+	const Entity extraEntity = entityManager.addEntity();
+	EXPECT_EQ(0, gReportedErrorsCount);
+
+	entityManager.addComponent<TransformComponent>(extraEntity);
+	EXPECT_EQ(1, gReportedErrorsCount);
+}
+
+TEST(EntityManager, FrozenEntityManager_ExceedScheduledActionsCapacity_ErrorIsReported)
+{
+	using namespace TestEntityManager_RealTime_Internal;
+
+	// only the scheduled actions queue is too small for all the scheduled actions
+	FrozenCapacities capacities(11);
+	capacities.scheduledActions = 10;
+	auto entityManagerData = PrepareFrozenEntityManager(capacities);
+	EntityManager& entityManager = entityManagerData->entityManager;
+
+	std::vector<Entity> entities;
+	entities.reserve(11);
+	for (int i = 0; i < 11; ++i)
+	{
+		entities.push_back(entityManager.addEntity());
+	}
+
+	ScopedReportedErrorsCounter errorsCounter;
+
+	for (int i = 0; i < 10; ++i)
+	{
+		entityManager.scheduleAddComponent<TransformComponent>(entities[i]);
+	}
+	EXPECT_EQ(0, gReportedErrorsCount);
+
+	entityManager.scheduleAddComponent<TransformComponent>(entities[10]);
+	EXPECT_EQ(1, gReportedErrorsCount);
+
+	entityManager.executeScheduledActions();
+	EXPECT_EQ(1, gReportedErrorsCount);
+	EXPECT_EQ(static_cast<size_t>(11), entityManager.getMatchingEntitiesCount<TransformComponent>());
+}
+
+TEST(EntityManager, FrozenEntityManager_ExceedIndexCapacity_ErrorIsReported)
+{
+	using namespace TestEntityManager_RealTime_Internal;
+
+	// the entities and both pools have room for one more entity, only the index doesn't
+	FrozenCapacities capacities(11);
+	capacities.indexedEntities = 10;
+	auto entityManagerData = PrepareFrozenEntityManager(capacities);
+	EntityManager& entityManager = entityManagerData->entityManager;
+
+	for (int i = 0; i < 10; ++i)
+	{
+		const Entity entity = entityManager.addEntity();
+		entityManager.addComponent<TransformComponent>(entity);
+		entityManager.addComponent<MovementComponent>(entity);
+	}
+
+	ScopedReportedErrorsCounter errorsCounter;
+
+	const Entity extraEntity = entityManager.addEntity();
+	entityManager.addComponent<TransformComponent>(extraEntity);
+	EXPECT_EQ(0, gReportedErrorsCount);
+
+	// the entity starts matching the index only when it gets the second component
+	entityManager.addComponent<MovementComponent>(extraEntity);
+	EXPECT_EQ(1, gReportedErrorsCount);
+}
+
+TEST(EntityManager, FrozenEntityManager_BindToUnreservedDelegate_ErrorIsReported)
+{
+	using namespace TestEntityManager_RealTime_Internal;
+
+	auto entityManagerData = PrepareFrozenEntityManager(10);
+	EntityManager& entityManager = entityManagerData->entityManager;
+
+	ScopedReportedErrorsCounter errorsCounter;
+
+	// delegates owned by a frozen manager can't grow their list of bound functions either
+	entityManager.onComponentsAdded<TransformComponent>().bind([](std::span<const Entity>) {});
+	EXPECT_EQ(1, gReportedErrorsCount);
+}
+
+TEST(EntityManager, UnfrozenEntityManager_ExceedCapacity_NoErrorIsReported)
+{
+	using namespace TestEntityManager_RealTime_Internal;
+
+	auto entityManagerData = PrepareFrozenEntityManager(10);
+	EntityManager& entityManager = entityManagerData->entityManager;
+	entityManager.unfreeze();
+	EXPECT_FALSE(entityManager.isFrozen());
+
+	ScopedReportedErrorsCounter errorsCounter;
+
+	for (int i = 0; i < 20; ++i)
+	{
+		const Entity entity = entityManager.addEntity();
+		entityManager.addComponent<TransformComponent>(entity);
+	}
+
+	EXPECT_EQ(0, gReportedErrorsCount);
+	EXPECT_EQ(static_cast<size_t>(20), entityManager.getMatchingEntitiesCount<TransformComponent>());
+}
+#endif // RACCOON_ECS_DEBUG_CHECKS_ENABLED
@@ -0,0 +1,340 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <span>
+#include <vector>
+
+#include "raccoon-ecs/entity_manager.h"
+
+namespace TestEntityManager_SharedComponents_Internal
+{
+	enum ComponentType
+	{
+		TransformComponentId,
+		MaterialComponentId,
+	};
+
+	using ComponentFactory = RaccoonEcs::ComponentFactoryImpl<ComponentType>;
+	using EntityManager = RaccoonEcs::EntityManagerImpl<ComponentType>;
+	using Entity = RaccoonEcs::Entity;
+	template<typename T>
+	using Shared = RaccoonEcs::Shared<T>;
+
+	struct TransformComponent
+	{
+		int x;
+		int y;
+
+		static ComponentType GetTypeId() { return TransformComponentId; };
+	};
+
+	static int gMaterialCopiesCount = 0;
+
+	struct MaterialComponent
+	{
+		int shaderId = 0;
+		int textureId = 0;
+
+		MaterialComponent() = default;
+		MaterialComponent(int shaderId, int textureId)
+			: shaderId(shaderId)
+			, textureId(textureId)
+		{}
+
+		MaterialComponent(const MaterialComponent& other)
+			: shaderId(other.shaderId)
+			, textureId(other.textureId)
+		{
+			++gMaterialCopiesCount;
+		}
+
+		MaterialComponent& operator=(const MaterialComponent& other)
+		{
+			shaderId = other.shaderId;
+			textureId = other.textureId;
+			++gMaterialCopiesCount;
+			return *this;
+		}
+
+		bool operator==(const MaterialComponent& other) const { return shaderId == other.shaderId && textureId == other.textureId; }
+
+		static ComponentType GetTypeId() { return MaterialComponentId; };
+	};
+}
+
+namespace std
+{
+	template<>
+	struct hash<TestEntityManager_SharedComponents_Internal::MaterialComponent>
+	{
+		size_t operator()(const TestEntityManager_SharedComponents_Internal::MaterialComponent& material) const
+		{
+			return std::hash<int>()(material.shaderId) ^ (std::hash<int>()(material.textureId) << 1);
+		}
+	};
+}
+
+namespace TestEntityManager_SharedComponents_Internal
+{
+	struct EntityManagerData
+	{
+		ComponentFactory componentFactory;
+		EntityManager entityManager{componentFactory};
+	};
+
+	static void RegisterComponents(ComponentFactory& inOutFactory)
+	{
+		inOutFactory.registerComponent<TransformComponent>();
+		inOutFactory.registerSharedComponent<MaterialComponent>();
+	}
+
+	static std::unique_ptr<EntityManagerData> PrepareEntityManager()
+	{
+		auto data = std::make_unique<EntityManagerData>();
+		RegisterComponents(data->componentFactory);
+		return data;
+	}
+
+	// number of entities referencing the stored value equal to the given one
+	static size_t getSharedValueReferencesCount(EntityManager& entityManager, const MaterialComponent& value)
+	{
+		size_t referencesCount = 0;
+		entityManager.forEachSharedComponentGroup<MaterialComponent>(
+			[&referencesCount, &value](const MaterialComponent* material, std::span<const Entity> entities) {
+				if (*material == value)
+				{
+					referencesCount += entities.size();
+				}
+			}
+		);
+		return referencesCount;
+	}
+} // namespace EntityManagerTestInternals
+
+TEST(EntityManager, SharedComponents_SetEqualValues_ValueIsStoredOnce)
+{
+	using namespace TestEntityManager_SharedComponents_Internal;
+
+	auto entityManagerData = PrepareEntityManager();
+	EntityManager& entityManager = entityManagerData->entityManager;
+
+	std::vector<const MaterialComponent*> materials;
+	for (int i = 0; i < 100; ++i)
+	{
+		const Entity entity = entityManager.addEntity();
+		materials.push_back(entityManager.setSharedComponent(entity, MaterialComponent{i % 2, 7}));
+	}
+
+	EXPECT_EQ(static_cast<size_t>(2), entityManager.getSharedComponentValuesCount<MaterialComponent>());
+	EXPECT_NE(materials[0], materials[1]);
+	for (size_t i = 2; i < materials.size(); ++i)
+	{
+		EXPECT_EQ(materials[i % 2], materials[i]);
+	}
+	EXPECT_EQ(0, materials[0]->shaderId);
+	EXPECT_EQ(1, materials[1]->shaderId);
+}
+
+TEST(EntityManager, SharedComponents_RemoveLastReference_ValueIsReleased)
+{
+	using namespace TestEntityManager_SharedComponents_Internal;
+
+	auto entityManagerData = PrepareEntityManager();
+	EntityManager& entityManager = entityManagerData->entityManager;
+
+	const Entity entity1 = entityManager.addEntity();
+	entityManager.setSharedComponent(entity1, MaterialComponent{1, 1});
+	const Entity entity2 = entityManager.addEntity();
+	entityManager.setSharedComponent(entity2, MaterialComponent{1, 1});
+	const Entity entity3 = entityManager.addEntity();
+	entityManager.setSharedComponent(entity3, MaterialComponent{2, 2});
+
+	EXPECT_EQ(static_cast<size_t>(2), entityManager.getSharedComponentValuesCount<MaterialComponent>());
+
+	entityManager.removeComponent<MaterialComponent>(entity1);
+	EXPECT_EQ(static_cast<size_t>(2), entityManager.getSharedComponentValuesCount<MaterialComponent>());
+	EXPECT_FALSE(entityManager.doesEntityHaveComponent<MaterialComponent>(entity1));
+
+	entityManager.removeEntity(entity2);
+	EXPECT_EQ(static_cast<size_t>(1), entityManager.getSharedComponentValuesCount<MaterialComponent>());
+
+	// replacing the value releases the old one as well
+	entityManager.setSharedComponent(entity3, MaterialComponent{3, 3});
+	EXPECT_EQ(static_cast<size_t>(1), entityManager.getSharedComponentValuesCount<MaterialComponent>());
+	auto [material] = entityManager.getEntityComponents<Shared<MaterialComponent>>(entity3);
+	ASSERT_NE(nullptr, material);
+	EXPECT_EQ(3, material->shaderId);
+}
+
+TEST(EntityManager, SharedComponents_QueryTogetherWithRegularComponents_SharedValuesAreConst)
+{
+	using namespace TestEntityManager_SharedComponents_Internal;
+
+	auto entityManagerData = PrepareEntityManager();
+	EntityManager& entityManager = entityManagerData->entityManager;
+
+	for (int i = 0; i < 10; ++i)
+	{
+		const Entity entity = entityManager.addEntity();
+		entityManager.addComponent<TransformComponent>(entity)->x = i;
+		if (i % 2 == 0)
+		{
+			entityManager.setSharedComponent(entity, MaterialComponent{5, 5});
+		}
+	}
+
+	int iterationsCount = 0;
+	entityManager.forEachComponentSet<TransformComponent, Shared<MaterialComponent>>(
+		[&iterationsCount](TransformComponent* transform, const MaterialComponent* material) {
+			EXPECT_EQ(0, transform->x % 2);
+			EXPECT_EQ(5, material->shaderId);
+			++iterationsCount;
+		}
+	);
+	EXPECT_EQ(5, iterationsCount);
+	EXPECT_EQ(static_cast<size_t>(5), (entityManager.getMatchingEntitiesCount<TransformComponent, Shared<MaterialComponent>>()));
+}
+
+TEST(EntityManager, SharedComponents_ForEachSharedComponentGroup_EachValueIsVisitedOnceWithItsEntities)
+{
+	using namespace TestEntityManager_SharedComponents_Internal;
+
+	auto entityManagerData = PrepareEntityManager();
+	EntityManager& entityManager = entityManagerData->entityManager;
+
+	std::map<int, std::vector<Entity>> expectedGroups;
+	for (int i = 0; i < 30; ++i)
+	{
+		const Entity entity = entityManager.addEntity();
+		entityManager.setSharedComponent(entity, MaterialComponent{i % 3, 0});
+		expectedGroups[i % 3].push_back(entity);
+	}
+
+	std::map<int, std::vector<Entity>> visitedGroups;
+	int groupsCount = 0;
+	entityManager.forEachSharedComponentGroup<MaterialComponent>(
+		[&visitedGroups, &groupsCount](const MaterialComponent* material, std::span<const Entity> entities) {
+			++groupsCount;
+			std::vector<Entity>& groupEntities = visitedGroups[material->shaderId];
+			groupEntities.insert(groupEntities.end(), entities.begin(), entities.end());
+		}
+	);
+
+	EXPECT_EQ(3, groupsCount);
+	for (auto& [shaderId, entities] : expectedGroups)
+	{
+		std::sort(entities.begin(), entities.end());
+		std::sort(visitedGroups[shaderId].begin(), visitedGroups[shaderId].end());
+		EXPECT_EQ(entities, visitedGroups[shaderId]);
+	}
+}
+
+TEST(EntityManager, SharedComponents_CloneEntityManager_EachValueIsCopiedOnce)
+{
+	using namespace TestEntityManager_SharedComponents_Internal;
+
+	auto entityManagerData = PrepareEntityManager();
+	EntityManager& entityManager = entityManagerData->entityManager;
+
+	for (int i = 0; i < 100; ++i)
+	{
+		const Entity entity = entityManager.addEntity();
+		entityManager.addComponent<TransformComponent>(entity);
+		entityManager.setSharedComponent(entity, MaterialComponent{i % 2, 0});
+	}
+
+	EntityManager entityManagerCopy(entityManagerData->componentFactory);
+	gMaterialCopiesCount = 0;
+	entityManagerCopy.overrideBy(entityManager);
+
+	EXPECT_EQ(2, gMaterialCopiesCount);
+	EXPECT_EQ(static_cast<size_t>(2), entityManagerCopy.getSharedComponentValuesCount<MaterialComponent>());
+	EXPECT_EQ(static_cast<size_t>(100), (entityManagerCopy.getMatchingEntitiesCount<TransformComponent, Shared<MaterialComponent>>()));
+}
+
+TEST(EntityManager, SharedComponents_TransferEntities_ValuesAreDeduplicatedInDestination)
+{
+	using namespace TestEntityManager_SharedComponents_Internal;
+
+	auto entityManagerData1 = PrepareEntityManager();
+	EntityManager& entityManager1 = entityManagerData1->entityManager;
+	EntityManager entityManager2(entityManagerData1->componentFactory);
+
+	const Entity entity1 = entityManager1.addEntity();
+	entityManager1.setSharedComponent(entity1, MaterialComponent{4, 4});
+	const Entity entity2 = entityManager1.addEntity();
+	entityManager1.setSharedComponent(entity2, MaterialComponent{4, 4});
+
+	const Entity transferredEntity1 = entityManager1.transferEntityTo(entityManager2, entity1);
+	const Entity transferredEntity2 = entityManager1.transferEntityTo(entityManager2, entity2);
+
+	EXPECT_EQ(static_cast<size_t>(0), entityManager1.getSharedComponentValuesCount<MaterialComponent>());
+	EXPECT_EQ(static_cast<size_t>(1), entityManager2.getSharedComponentValuesCount<MaterialComponent>());
+
+	auto [material1] = entityManager2.getEntityComponents<Shared<MaterialComponent>>(transferredEntity1);
+	auto [material2] = entityManager2.getEntityComponents<Shared<MaterialComponent>>(transferredEntity2);
+	ASSERT_NE(nullptr, material1);
+	EXPECT_EQ(material1, material2);
+	EXPECT_EQ(4, material1->textureId);
+}
+
+TEST(EntityManager, SharedComponents_TransferEntitiesWithValueExistingInDestination_ExistingValueIsReused)
+{
+	using namespace TestEntityManager_SharedComponents_Internal;
+
+	auto entityManagerData1 = PrepareEntityManager();
+	EntityManager& entityManager1 = entityManagerData1->entityManager;
+	EntityManager entityManager2(entityManagerData1->componentFactory);
+
+	const Entity existingEntity = entityManager2.addEntity();
+	const MaterialComponent* existingMaterial = entityManager2.setSharedComponent(existingEntity, MaterialComponent{4, 4});
+	ASSERT_EQ(static_cast<size_t>(1), entityManager2.getSharedComponentValuesCount<MaterialComponent>());
+	ASSERT_EQ(static_cast<size_t>(1), getSharedValueReferencesCount(entityManager2, MaterialComponent{4, 4}));
+
+	const Entity entity1 = entityManager1.addEntity();
+	entityManager1.setSharedComponent(entity1, MaterialComponent{4, 4});
+	const Entity entity2 = entityManager1.addEntity();
+	entityManager1.setSharedComponent(entity2, MaterialComponent{4, 4});
+
+	gMaterialCopiesCount = 0;
+	const Entity transferredEntity1 = entityManager1.transferEntityTo(entityManager2, entity1);
+	const Entity transferredEntity2 = entityManager1.transferEntityTo(entityManager2, entity2);
+
+	// the equal value already stored in the destination is referenced instead of a new one being stored
+	EXPECT_EQ(0, gMaterialCopiesCount);
+	EXPECT_EQ(static_cast<size_t>(1), entityManager2.getSharedComponentValuesCount<MaterialComponent>());
+	EXPECT_EQ(static_cast<size_t>(3), getSharedValueReferencesCount(entityManager2, MaterialComponent{4, 4}));
+
+	auto [material1] = entityManager2.getEntityComponents<Shared<MaterialComponent>>(transferredEntity1);
+	auto [material2] = entityManager2.getEntityComponents<Shared<MaterialComponent>>(transferredEntity2);
+	EXPECT_EQ(existingMaterial, material1);
+	EXPECT_EQ(existingMaterial, material2);
+}
+
+TEST(EntityManager, SharedComponents_ClearKeepingCapacity_ReferencesAreReleased)
+{
+	using namespace TestEntityManager_SharedComponents_Internal;
+
+	auto entityManagerData = PrepareEntityManager();
+	EntityManager& entityManager = entityManagerData->entityManager;
+
+	for (int i = 0; i < 10; ++i)
+	{
+		const Entity entity = entityManager.addEntity();
+		entityManager.setSharedComponent(entity, MaterialComponent{i % 2, 0});
+	}
+	ASSERT_EQ(static_cast<size_t>(2), entityManager.getSharedComponentValuesCount<MaterialComponent>());
+
+	entityManager.clear(EntityManager::ClearMode::KeepCapacity);
+
+	EXPECT_EQ(static_cast<size_t>(0), entityManager.getSharedComponentValuesCount<MaterialComponent>());
+	EXPECT_EQ(static_cast<size_t>(0), getSharedValueReferencesCount(entityManager, MaterialComponent{0, 0}));
+
+	// a value set after clearing starts with a single reference
+	const Entity entity = entityManager.addEntity();
+	entityManager.setSharedComponent(entity, MaterialComponent{0, 0});
+	EXPECT_EQ(static_cast<size_t>(1), entityManager.getSharedComponentValuesCount<MaterialComponent>());
+	EXPECT_EQ(static_cast<size_t>(1), getSharedValueReferencesCount(entityManager, MaterialComponent{0, 0}));
+}
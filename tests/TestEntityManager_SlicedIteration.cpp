@@ -0,0 +1,185 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <map>
+#include <vector>
+
+#include "raccoon-ecs/entity_manager.h"
+
+namespace TestEntityManager_SlicedIteration_Internal
+{
+	enum ComponentType
+	{
+		TransformComponentId,
+		MovementComponentId,
+	};
+
+	using ComponentFactory = RaccoonEcs::ComponentFactoryImpl<ComponentType>;
+	using EntityManager = RaccoonEcs::EntityManagerImpl<ComponentType>;
+	using Entity = RaccoonEcs::Entity;
+	using SlicedIterationCursor = RaccoonEcs::SlicedIterationCursor;
+
+	struct TransformComponent
+	{
+		int x;
+		int y;
+
+		static ComponentType GetTypeId() { return TransformComponentId; };
+	};
+
+	struct MovementComponent
+	{
+		int dx;
+		int dy;
+
+		static ComponentType GetTypeId() { return MovementComponentId; };
+	};
+
+	struct EntityManagerData
+	{
+		ComponentFactory componentFactory;
+		EntityManager entityManager{componentFactory};
+	};
+
+	static void RegisterComponents(ComponentFactory& inOutFactory)
+	{
+		inOutFactory.registerComponent<TransformComponent>();
+		inOutFactory.registerComponent<MovementComponent>();
+	}
+
+	static std::unique_ptr<EntityManagerData> PrepareEntityManager()
+	{
+		auto data = std::make_unique<EntityManagerData>();
+		RegisterComponents(data->componentFactory);
+		return data;
+	}
+
+	static std::vector<Entity> addEntities(EntityManager& entityManager, int count)
+	{
+		std::vector<Entity> result;
+		for (int i = 0; i < count; ++i)
+		{
+			const Entity entity = entityManager.addEntity();
+			entityManager.addComponent<TransformComponent>(entity);
+			entityManager.addComponent<MovementComponent>(entity);
+			result.push_back(entity);
+		}
+		return result;
+	}
+} // namespace EntityManagerTestInternals
+
+TEST(EntityManager, SlicedIteration_IterateOverAllSlices_EachEntityIsVisitedExactlyOnce)
+{
+	using namespace TestEntityManager_SlicedIteration_Internal;
+
+	auto entityManagerData = PrepareEntityManager();
+	EntityManager& entityManager = entityManagerData->entityManager;
+	std::vector<Entity> entities = addEntities(entityManager, 50);
+
+	constexpr size_t slicesCount = 4;
+	std::vector<Entity> visitedEntities;
+	for (size_t sliceIndex = 0; sliceIndex < slicesCount; ++sliceIndex)
+	{
+		int iterationsCount = 0;
+		entityManager.forEachComponentSetWithEntitySliced<TransformComponent, MovementComponent>(
+			sliceIndex,
+			slicesCount,
+			[&visitedEntities, &iterationsCount](Entity entity, TransformComponent*, MovementComponent*) {
+				visitedEntities.push_back(entity);
+				++iterationsCount;
+			}
+		);
+		// slices don't have to be perfectly even but none of them should take the whole work
+		EXPECT_LT(iterationsCount, 50);
+	}
+
+	std::sort(entities.begin(), entities.end());
+	std::sort(visitedEntities.begin(), visitedEntities.end());
+	EXPECT_EQ(entities, visitedEntities);
+}
+
+TEST(EntityManager, SlicedIteration_SingleSlice_AllEntitiesAreVisited)
+{
+	using namespace TestEntityManager_SlicedIteration_Internal;
+
+	auto entityManagerData = PrepareEntityManager();
+	EntityManager& entityManager = entityManagerData->entityManager;
+	addEntities(entityManager, 10);
+
+	int iterationsCount = 0;
+	entityManager.forEachComponentSetSliced<TransformComponent>(0, 1, [&iterationsCount](TransformComponent*) {
+		++iterationsCount;
+	});
+	EXPECT_EQ(10, iterationsCount);
+}
+
+TEST(EntityManager, SlicedIterationWithCursor_IterateForSlicesCountFrames_EachEntityIsVisitedExactlyOnce)
+{
+	using namespace TestEntityManager_SlicedIteration_Internal;
+
+	auto entityManagerData = PrepareEntityManager();
+	EntityManager& entityManager = entityManagerData->entityManager;
+	const std::vector<Entity> entities = addEntities(entityManager, 30);
+
+	SlicedIterationCursor cursor(3);
+	for (int cycle = 0; cycle < 2; ++cycle)
+	{
+		std::map<Entity, int> visitsCount;
+		for (int frame = 0; frame < 3; ++frame)
+		{
+			entityManager.forEachComponentSetWithEntitySliced<TransformComponent>(cursor, [&visitsCount](Entity entity, TransformComponent*) {
+				++visitsCount[entity];
+			});
+		}
+
+		ASSERT_EQ(entities.size(), visitsCount.size());
+		for (const auto& [entity, count] : visitsCount)
+		{
+			EXPECT_EQ(1, count);
+		}
+	}
+}
+
+TEST(EntityManager, SlicedIterationWithCursor_StructuralChangesBetweenFrames_SurvivingEntitiesAreVisitedExactlyOnce)
+{
+	using namespace TestEntityManager_SlicedIteration_Internal;
+
+	auto entityManagerData = PrepareEntityManager();
+	EntityManager& entityManager = entityManagerData->entityManager;
+	std::vector<Entity> entities = addEntities(entityManager, 40);
+
+	SlicedIterationCursor cursor(4);
+	std::map<Entity, int> visitsCount;
+
+	for (int frame = 0; frame < 4; ++frame)
+	{
+		entityManager.forEachComponentSetWithEntitySliced<TransformComponent, MovementComponent>(
+			cursor,
+			[&visitsCount](Entity entity, TransformComponent*, MovementComponent*) {
+				++visitsCount[entity];
+			}
+		);
+
+		// remove a few entities and add new ones, which shuffles the dense component storage
+		for (int i = 0; i < 3; ++i)
+		{
+			entityManager.removeEntity(entities.back());
+			entities.pop_back();
+		}
+		entityManager.removeEntity(entities.front());
+		entities.erase(entities.begin());
+		addEntities(entityManager, 2);
+	}
+
+	// every entity that existed for the whole cycle was visited exactly once
+	for (const Entity entity : entities)
+	{
+		EXPECT_EQ(1, visitsCount[entity]);
+	}
+
+	// no entity was visited more than once, even if it was removed during the cycle
+	for (const auto& [entity, count] : visitsCount)
+	{
+		EXPECT_LE(count, 1);
+	}
+}
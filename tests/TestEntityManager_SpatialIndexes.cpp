@@ -0,0 +1,410 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#include "raccoon-ecs/entity_manager.h"
+
+namespace TestEntityManager_SpatialIndexes_Internal
+{
+	enum ComponentType
+	{
+		TransformComponentId,
+		MovementComponentId,
+	};
+
+	using ComponentFactory = RaccoonEcs::ComponentFactoryImpl<ComponentType>;
+	using EntityManager = RaccoonEcs::EntityManagerImpl<ComponentType>;
+	using Entity = RaccoonEcs::Entity;
+	using SpatialPosition = RaccoonEcs::SpatialPosition;
+
+	struct TransformComponent
+	{
+		float x;
+		float y;
+
+		static ComponentType GetTypeId() { return TransformComponentId; };
+	};
+
+	struct MovementComponent
+	{
+		float dx;
+		float dy;
+
+		static ComponentType GetTypeId() { return MovementComponentId; };
+	};
+
+	struct EntityManagerData
+	{
+		ComponentFactory componentFactory;
+		EntityManager entityManager{componentFactory};
+	};
+
+	static SpatialPosition GetTransformPosition(const TransformComponent* transform)
+	{
+		return SpatialPosition{transform->x, transform->y};
+	}
+
+	static void RegisterComponents(ComponentFactory& inOutFactory)
+	{
+		inOutFactory.registerComponent<TransformComponent>();
+		inOutFactory.registerComponent<MovementComponent>();
+	}
+
+	static std::unique_ptr<EntityManagerData> PrepareEntityManager()
+	{
+		auto data = std::make_unique<EntityManagerData>();
+		RegisterComponents(data->componentFactory);
+		data->entityManager.initSpatialIndex<TransformComponent>(&GetTransformPosition, 10.0f);
+		return data;
+	}
+
+	static Entity addEntityAt(EntityManager& entityManager, float x, float y)
+	{
+		const Entity entity = entityManager.addEntity();
+		TransformComponent* transform = entityManager.addComponent<TransformComponent>(entity);
+		transform->x = x;
+		transform->y = y;
+		return entity;
+	}
+
+	static void checkSameEntities(std::vector<Entity> expected, std::vector<Entity> actual)
+	{
+		std::sort(expected.begin(), expected.end());
+		std::sort(actual.begin(), actual.end());
+		EXPECT_EQ(expected, actual);
+	}
+
+	// the kind of grid users build by hand on top of forEachComponentSetWithEntity, rebuilt from scratch every frame
+	class RebuiltGrid
+	{
+	public:
+		explicit RebuiltGrid(float cellSize)
+			: mCellSize(cellSize)
+		{}
+
+		void rebuild(EntityManager& entityManager)
+		{
+			for (auto& [cellKey, cell] : mCells)
+			{
+				cell.clear();
+			}
+			entityManager.forEachComponentSetWithEntity<const TransformComponent>([this](Entity entity, const TransformComponent* transform) {
+				mCells[getCellKey(getCellCoordinate(transform->x), getCellCoordinate(transform->y))].push_back({entity, GetTransformPosition(transform)});
+			});
+		}
+
+		void getEntitiesInBox(SpatialPosition min, SpatialPosition max, std::vector<Entity>& outEntities) const
+		{
+			forEachInCells(min, max, [&outEntities, min, max](Entity entity, SpatialPosition position) {
+				if (position.x >= min.x && position.x <= max.x && position.y >= min.y && position.y <= max.y)
+				{
+					outEntities.push_back(entity);
+				}
+			});
+		}
+
+		void getEntitiesInRadius(SpatialPosition center, float radius, std::vector<Entity>& outEntities) const
+		{
+			const SpatialPosition min{center.x - radius, center.y - radius};
+			const SpatialPosition max{center.x + radius, center.y + radius};
+			forEachInCells(min, max, [&outEntities, center, radius](Entity entity, SpatialPosition position) {
+				const float dx = position.x - center.x;
+				const float dy = position.y - center.y;
+				if (dx * dx + dy * dy <= radius * radius)
+				{
+					outEntities.push_back(entity);
+				}
+			});
+		}
+
+	private:
+		struct Record
+		{
+			Entity entity;
+			SpatialPosition position;
+		};
+
+		std::int32_t getCellCoordinate(float value) const
+		{
+			return static_cast<std::int32_t>(std::floor(value / mCellSize));
+		}
+
+		static std::int64_t getCellKey(std::int32_t cellX, std::int32_t cellY)
+		{
+			return (static_cast<std::int64_t>(cellX) << 32) | static_cast<std::uint32_t>(cellY);
+		}
+
+		template<typename Func>
+		void forEachInCells(SpatialPosition min, SpatialPosition max, Func&& func) const
+		{
+			for (std::int32_t cellX = getCellCoordinate(min.x); cellX <= getCellCoordinate(max.x); ++cellX)
+			{
+				for (std::int32_t cellY = getCellCoordinate(min.y); cellY <= getCellCoordinate(max.y); ++cellY)
+				{
+					const auto it = mCells.find(getCellKey(cellX, cellY));
+					if (it != mCells.end())
+					{
+						for (const Record& record : it->second)
+						{
+							func(record.entity, record.position);
+						}
+					}
+				}
+			}
+		}
+
+		float mCellSize;
+		std::unordered_map<std::int64_t, std::vector<Record>> mCells;
+	};
+} // namespace EntityManagerTestInternals
+
+TEST(EntityManager, EntityManagerWithSpatialIndex_GetEntitiesInRadius_ReturnsEntitiesWithinRadius)
+{
+	using namespace TestEntityManager_SpatialIndexes_Internal;
+
+	auto entityManagerData = PrepareEntityManager();
+	EntityManager& entityManager = entityManagerData->entityManager;
+
+	const Entity entity1 = addEntityAt(entityManager, 0.0f, 0.0f);
+	const Entity entity2 = addEntityAt(entityManager, 3.0f, 4.0f);
+	const Entity entity3 = addEntityAt(entityManager, 15.0f, 0.0f);
+	addEntityAt(entityManager, -40.0f, 25.0f);
+
+	{
+		std::vector<Entity> result;
+		entityManager.getEntitiesInRadius<TransformComponent>(SpatialPosition{0.0f, 0.0f}, 5.0f, result);
+		checkSameEntities({entity1, entity2}, result);
+	}
+
+	{
+		std::vector<Entity> result;
+		entityManager.getEntitiesInRadius<TransformComponent>(SpatialPosition{10.0f, 0.0f}, 6.0f, result);
+		checkSameEntities({entity3}, result);
+	}
+}
+
+TEST(EntityManager, EntityManagerWithSpatialIndex_GetEntitiesInBox_ReturnsEntitiesInsideBox)
+{
+	using namespace TestEntityManager_SpatialIndexes_Internal;
+
+	auto entityManagerData = PrepareEntityManager();
+	EntityManager& entityManager = entityManagerData->entityManager;
+
+	const Entity entity1 = addEntityAt(entityManager, 1.0f, 1.0f);
+	addEntityAt(entityManager, 25.0f, 1.0f);
+	const Entity entity3 = addEntityAt(entityManager, 19.0f, 19.0f);
+	addEntityAt(entityManager, -1.0f, 5.0f);
+
+	std::vector<Entity> result;
+	entityManager.getEntitiesInBox<TransformComponent>(SpatialPosition{0.0f, 0.0f}, SpatialPosition{20.0f, 20.0f}, result);
+	checkSameEntities({entity1, entity3}, result);
+}
+
+TEST(EntityManager, EntityManagerWithSpatialIndex_ModifyComponent_EntityMovesBetweenCells)
+{
+	using namespace TestEntityManager_SpatialIndexes_Internal;
+
+	auto entityManagerData = PrepareEntityManager();
+	EntityManager& entityManager = entityManagerData->entityManager;
+
+	const Entity entity = addEntityAt(entityManager, 0.0f, 0.0f);
+
+	entityManager.modifyComponent<TransformComponent>(entity, [](TransformComponent* transform) {
+		transform->x = 100.0f;
+		transform->y = 100.0f;
+	});
+
+	{
+		std::vector<Entity> result;
+		entityManager.getEntitiesInRadius<TransformComponent>(SpatialPosition{0.0f, 0.0f}, 5.0f, result);
+		EXPECT_TRUE(result.empty());
+	}
+
+	{
+		std::vector<Entity> result;
+		entityManager.getEntitiesInRadius<TransformComponent>(SpatialPosition{100.0f, 100.0f}, 5.0f, result);
+		checkSameEntities({entity}, result);
+	}
+}
+
+TEST(EntityManager, EntityManagerWithSpatialIndex_RemoveComponentOrEntity_EntityIsNotReturned)
+{
+	using namespace TestEntityManager_SpatialIndexes_Internal;
+
+	auto entityManagerData = PrepareEntityManager();
+	EntityManager& entityManager = entityManagerData->entityManager;
+
+	const Entity entity1 = addEntityAt(entityManager, 0.0f, 0.0f);
+	const Entity entity2 = addEntityAt(entityManager, 1.0f, 0.0f);
+	const Entity entity3 = addEntityAt(entityManager, 2.0f, 0.0f);
+
+	entityManager.removeComponent<TransformComponent>(entity1);
+	entityManager.removeEntity(entity2);
+
+	std::vector<Entity> result;
+	entityManager.getEntitiesInRadius<TransformComponent>(SpatialPosition{0.0f, 0.0f}, 5.0f, result);
+	checkSameEntities({entity3}, result);
+}
+
+TEST(EntityManager, EntityManagerWithSpatialIndex_MoveManyEntities_QueriesMatchFullScan)
+{
+	using namespace TestEntityManager_SpatialIndexes_Internal;
+
+	auto entityManagerData = PrepareEntityManager();
+	EntityManager& entityManager = entityManagerData->entityManager;
+
+	std::mt19937 randomGenerator(42);
+	std::uniform_real_distribution<float> positionDistribution(-200.0f, 200.0f);
+	std::uniform_real_distribution<float> speedDistribution(-15.0f, 15.0f);
+
+	for (int i = 0; i < 2000; ++i)
+	{
+		const Entity entity = addEntityAt(entityManager, positionDistribution(randomGenerator), positionDistribution(randomGenerator));
+		MovementComponent* movement = entityManager.addComponent<MovementComponent>(entity);
+		movement->dx = speedDistribution(randomGenerator);
+		movement->dy = speedDistribution(randomGenerator);
+	}
+
+	for (int frame = 0; frame < 10; ++frame)
+	{
+		entityManager.forEachComponentSetWithEntity<const MovementComponent>([&entityManager](Entity entity, const MovementComponent* movement) {
+			entityManager.modifyComponent<TransformComponent>(entity, [movement](TransformComponent* transform) {
+				transform->x += movement->dx;
+				transform->y += movement->dy;
+			});
+		});
+
+		const SpatialPosition center{positionDistribution(randomGenerator), positionDistribution(randomGenerator)};
+		const float radius = 30.0f;
+
+		std::vector<Entity> expected;
+		entityManager.forEachComponentSetWithEntity<const TransformComponent>([&expected, center, radius](Entity entity, const TransformComponent* transform) {
+			const float dx = transform->x - center.x;
+			const float dy = transform->y - center.y;
+			if (dx * dx + dy * dy <= radius * radius)
+			{
+				expected.push_back(entity);
+			}
+		});
+
+		std::vector<Entity> result;
+		entityManager.getEntitiesInRadius<TransformComponent>(center, radius, result);
+		checkSameEntities(expected, result);
+	}
+}
+
+// benchmark, run with --gtest_also_run_disabled_tests
+// 100k moving entities: incremental grid updates through modifyComponent against rebuilding a grid every frame
+TEST(EntityManager, DISABLED_Benchmark_SpatialIndex_MovingEntities_IncrementalUpdatesAndFullRebuild)
+{
+	using namespace TestEntityManager_SpatialIndexes_Internal;
+
+	constexpr int entitiesCount = 100000;
+	constexpr int framesCount = 60;
+	constexpr int queriesPerFrame = 100;
+	constexpr float cellSize = 10.0f;
+	constexpr float worldHalfSize = 1000.0f;
+	constexpr float queryRadius = 25.0f;
+
+	// the same entities and movements in both managers, only the second one has the spatial index
+	ComponentFactory componentFactory;
+	RegisterComponents(componentFactory);
+	EntityManager rebuiltEntityManager(componentFactory);
+	EntityManager indexedEntityManager(componentFactory);
+	indexedEntityManager.initSpatialIndex<TransformComponent>(&GetTransformPosition, cellSize);
+
+	{
+		std::mt19937 randomGenerator(42);
+		std::uniform_real_distribution<float> positionDistribution(-worldHalfSize, worldHalfSize);
+		std::uniform_real_distribution<float> speedDistribution(-2.0f, 2.0f);
+		for (int i = 0; i < entitiesCount; ++i)
+		{
+			const float x = positionDistribution(randomGenerator);
+			const float y = positionDistribution(randomGenerator);
+			const float dx = speedDistribution(randomGenerator);
+			const float dy = speedDistribution(randomGenerator);
+			for (EntityManager* entityManager : {&rebuiltEntityManager, &indexedEntityManager})
+			{
+				const Entity entity = addEntityAt(*entityManager, x, y);
+				MovementComponent* movement = entityManager->addComponent<MovementComponent>(entity);
+				movement->dx = dx;
+				movement->dy = dy;
+			}
+		}
+	}
+
+	std::vector<SpatialPosition> queryCenters;
+	{
+		std::mt19937 randomGenerator(7);
+		std::uniform_real_distribution<float> positionDistribution(-worldHalfSize, worldHalfSize);
+		for (int i = 0; i < framesCount * queriesPerFrame; ++i)
+		{
+			queryCenters.push_back(SpatialPosition{positionDistribution(randomGenerator), positionDistribution(randomGenerator)});
+		}
+	}
+
+	size_t rebuiltFoundCount = 0;
+	RebuiltGrid rebuiltGrid(cellSize);
+	const auto rebuildStartTime = std::chrono::steady_clock::now();
+	for (int frame = 0; frame < framesCount; ++frame)
+	{
+		rebuiltEntityManager.forEachComponentSet<TransformComponent, const MovementComponent>([](TransformComponent* transform, const MovementComponent* movement) {
+			transform->x += movement->dx;
+			transform->y += movement->dy;
+		});
+		rebuiltGrid.rebuild(rebuiltEntityManager);
+
+		std::vector<Entity> result;
+		for (int i = 0; i < queriesPerFrame; ++i)
+		{
+			const SpatialPosition center = queryCenters[static_cast<size_t>(frame * queriesPerFrame + i)];
+			result.clear();
+			rebuiltGrid.getEntitiesInRadius(center, queryRadius, result);
+			rebuiltFoundCount += result.size();
+			result.clear();
+			rebuiltGrid.getEntitiesInBox(SpatialPosition{center.x - queryRadius, center.y - queryRadius}, SpatialPosition{center.x + queryRadius, center.y + queryRadius}, result);
+			rebuiltFoundCount += result.size();
+		}
+	}
+	const auto rebuildTime = std::chrono::steady_clock::now() - rebuildStartTime;
+
+	size_t indexedFoundCount = 0;
+	const auto incrementalStartTime = std::chrono::steady_clock::now();
+	for (int frame = 0; frame < framesCount; ++frame)
+	{
+		indexedEntityManager.forEachComponentSetWithEntity<const MovementComponent>([&indexedEntityManager](Entity entity, const MovementComponent* movement) {
+			indexedEntityManager.modifyComponent<TransformComponent>(entity, [movement](TransformComponent* transform) {
+				transform->x += movement->dx;
+				transform->y += movement->dy;
+			});
+		});
+
+		std::vector<Entity> result;
+		for (int i = 0; i < queriesPerFrame; ++i)
+		{
+			const SpatialPosition center = queryCenters[static_cast<size_t>(frame * queriesPerFrame + i)];
+			result.clear();
+			indexedEntityManager.getEntitiesInRadius<TransformComponent>(center, queryRadius, result);
+			indexedFoundCount += result.size();
+			result.clear();
+			indexedEntityManager.getEntitiesInBox<TransformComponent>(SpatialPosition{center.x - queryRadius, center.y - queryRadius}, SpatialPosition{center.x + queryRadius, center.y + queryRadius}, result);
+			indexedFoundCount += result.size();
+		}
+	}
+	const auto incrementalTime = std::chrono::steady_clock::now() - incrementalStartTime;
+
+	// both approaches see the same world, so they have to find the same entities
+	EXPECT_EQ(rebuiltFoundCount, indexedFoundCount);
+
+	std::cout << entitiesCount << " entities, " << framesCount << " frames, " << queriesPerFrame << " radius and box queries per frame"
+		<< ", full rebuild: " << std::chrono::duration_cast<std::chrono::milliseconds>(rebuildTime).count() << " ms"
+		<< ", incremental spatial index: " << std::chrono::duration_cast<std::chrono::milliseconds>(incrementalTime).count() << " ms"
+		<< std::endl;
+}
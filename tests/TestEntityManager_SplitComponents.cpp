@@ -0,0 +1,322 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "raccoon-ecs/entity_manager.h"
+
+namespace TestEntityManager_SplitComponents_Internal
+{
+	enum ComponentType
+	{
+		BodyComponentId,
+		TagComponentId,
+		UnsplitBodyComponentId,
+	};
+
+	using ComponentFactory = RaccoonEcs::ComponentFactoryImpl<ComponentType>;
+	using EntityManager = RaccoonEcs::EntityManagerImpl<ComponentType>;
+	using Entity = RaccoonEcs::Entity;
+	template<typename T>
+	using Hot = RaccoonEcs::Hot<T>;
+	template<typename T>
+	using Cold = RaccoonEcs::Cold<T>;
+	template<typename T>
+	using SplitComponentPtr = RaccoonEcs::SplitComponentPtr<T>;
+
+	struct BodyComponent
+	{
+		struct Hot
+		{
+			float x;
+			float y;
+			float vx;
+			float vy;
+		};
+
+		struct Cold
+		{
+			std::string debugName;
+			int spawnFrame;
+			int ownerId;
+		};
+
+		static ComponentType GetTypeId() { return BodyComponentId; };
+	};
+
+	struct TagComponent
+	{
+		static ComponentType GetTypeId() { return TagComponentId; };
+	};
+
+	// the same fields as BodyComponent stored in one regular pool
+	struct UnsplitBodyComponent
+	{
+		BodyComponent::Hot hot;
+		BodyComponent::Cold cold;
+
+		static ComponentType GetTypeId() { return UnsplitBodyComponentId; };
+	};
+
+	struct EntityManagerData
+	{
+		ComponentFactory componentFactory;
+		EntityManager entityManager{componentFactory};
+	};
+
+	static void RegisterComponents(ComponentFactory& inOutFactory)
+	{
+		inOutFactory.registerSplitComponent<BodyComponent>();
+		inOutFactory.registerComponent<TagComponent>();
+	}
+
+	static std::unique_ptr<EntityManagerData> PrepareEntityManager()
+	{
+		auto data = std::make_unique<EntityManagerData>();
+		RegisterComponents(data->componentFactory);
+		return data;
+	}
+
+	static std::vector<Entity> addBodies(EntityManager& entityManager, int count)
+	{
+		std::vector<Entity> result;
+		for (int i = 0; i < count; ++i)
+		{
+			const Entity entity = entityManager.addEntity();
+			SplitComponentPtr<BodyComponent> body = entityManager.addComponent<BodyComponent>(entity);
+			body.hot->x = static_cast<float>(i);
+			body.hot->vx = 1.0f;
+			body.cold->debugName = "body" + std::to_string(i);
+			body.cold->spawnFrame = i;
+			result.push_back(entity);
+		}
+		return result;
+	}
+} // namespace EntityManagerTestInternals
+
+TEST(EntityManager, SplitComponents_AddComponent_HotAndColdPartsAreAccessible)
+{
+	using namespace TestEntityManager_SplitComponents_Internal;
+
+	auto entityManagerData = PrepareEntityManager();
+	EntityManager& entityManager = entityManagerData->entityManager;
+	const std::vector<Entity> entities = addBodies(entityManager, 3);
+
+	auto [body] = entityManager.getEntityComponents<BodyComponent>(entities[2]);
+	ASSERT_NE(nullptr, body.hot);
+	ASSERT_NE(nullptr, body.cold);
+	EXPECT_EQ(2.0f, body.hot->x);
+	EXPECT_EQ("body2", body.cold->debugName);
+
+	auto [hot] = entityManager.getEntityComponents<Hot<BodyComponent>>(entities[1]);
+	ASSERT_NE(nullptr, hot);
+	EXPECT_EQ(1.0f, hot->x);
+
+	auto [cold] = entityManager.getEntityComponents<Cold<BodyComponent>>(entities[1]);
+	ASSERT_NE(nullptr, cold);
+	EXPECT_EQ(1, cold->spawnFrame);
+}
+
+TEST(EntityManager, SplitComponents_IterateOverHotParts_OnlyHotPartsArePassed)
+{
+	using namespace TestEntityManager_SplitComponents_Internal;
+
+	auto entityManagerData = PrepareEntityManager();
+	EntityManager& entityManager = entityManagerData->entityManager;
+	addBodies(entityManager, 10);
+
+	entityManager.forEachComponentSet<Hot<BodyComponent>>([](BodyComponent::Hot* hot) {
+		hot->x += hot->vx;
+	});
+
+	int iterationsCount = 0;
+	entityManager.forEachComponentSet<BodyComponent>([&iterationsCount](SplitComponentPtr<BodyComponent> body) {
+		EXPECT_EQ(static_cast<float>(body.cold->spawnFrame) + 1.0f, body.hot->x);
+		++iterationsCount;
+	});
+	EXPECT_EQ(10, iterationsCount);
+}
+
+TEST(EntityManager, SplitComponents_CollectHotParts_HotPartsAreStoredContiguously)
+{
+	using namespace TestEntityManager_SplitComponents_Internal;
+
+	auto entityManagerData = PrepareEntityManager();
+	EntityManager& entityManager = entityManagerData->entityManager;
+	addBodies(entityManager, 64);
+
+	std::vector<std::tuple<BodyComponent::Hot*>> hotParts;
+	entityManager.getComponents<Hot<BodyComponent>>(hotParts);
+	ASSERT_EQ(static_cast<size_t>(64), hotParts.size());
+
+	std::vector<BodyComponent::Hot*> pointers;
+	for (auto [hot] : hotParts)
+	{
+		pointers.push_back(hot);
+	}
+	std::sort(pointers.begin(), pointers.end());
+
+	// cold data is kept out of the hot pool, so hot parts are packed next to each other
+	for (size_t i = 1; i < pointers.size(); ++i)
+	{
+		EXPECT_EQ(pointers[i - 1] + 1, pointers[i]);
+	}
+}
+
+TEST(EntityManager, SplitComponents_RemoveEntities_HotAndColdPartsStayPaired)
+{
+	using namespace TestEntityManager_SplitComponents_Internal;
+
+	auto entityManagerData = PrepareEntityManager();
+	EntityManager& entityManager = entityManagerData->entityManager;
+	std::vector<Entity> entities = addBodies(entityManager, 20);
+
+	std::vector<SplitComponentPtr<BodyComponent>> bodiesBeforeRemoval;
+	for (const Entity entity : entities)
+	{
+		auto [body] = entityManager.getEntityComponents<BodyComponent>(entity);
+		bodiesBeforeRemoval.push_back(body);
+	}
+
+	for (int i = 0; i < 5; ++i)
+	{
+		entityManager.removeEntity(entities[i * 3]);
+	}
+
+	// like regular components, neither part of the remaining components is moved by removals
+	for (size_t i = 0; i < entities.size(); ++i)
+	{
+		if (i % 3 == 0 && i < 15)
+		{
+			continue;
+		}
+		auto [body] = entityManager.getEntityComponents<BodyComponent>(entities[i]);
+		EXPECT_EQ(bodiesBeforeRemoval[i].hot, body.hot);
+		EXPECT_EQ(bodiesBeforeRemoval[i].cold, body.cold);
+	}
+
+	int iterationsCount = 0;
+	entityManager.forEachComponentSet<BodyComponent>([&iterationsCount](SplitComponentPtr<BodyComponent> body) {
+		EXPECT_EQ(static_cast<float>(body.cold->spawnFrame), body.hot->x);
+		EXPECT_EQ("body" + std::to_string(body.cold->spawnFrame), body.cold->debugName);
+		++iterationsCount;
+	});
+	EXPECT_EQ(15, iterationsCount);
+}
+
+TEST(EntityManager, SplitComponents_CombineWithOtherComponents_OnlyMatchingEntitiesAreVisited)
+{
+	using namespace TestEntityManager_SplitComponents_Internal;
+
+	auto entityManagerData = PrepareEntityManager();
+	EntityManager& entityManager = entityManagerData->entityManager;
+	const std::vector<Entity> entities = addBodies(entityManager, 10);
+	entityManager.addComponent<TagComponent>(entities[4]);
+	entityManager.addComponent<TagComponent>(entities[8]);
+
+	std::vector<float> visitedPositions;
+	entityManager.forEachComponentSet<TagComponent, Hot<BodyComponent>>([&visitedPositions](TagComponent*, BodyComponent::Hot* hot) {
+		visitedPositions.push_back(hot->x);
+	});
+	std::sort(visitedPositions.begin(), visitedPositions.end());
+	EXPECT_EQ(std::vector<float>({4.0f, 8.0f}), visitedPositions);
+}
+
+TEST(EntityManager, SplitComponents_CloneEntityManager_BothPartsAreCopied)
+{
+	using namespace TestEntityManager_SplitComponents_Internal;
+
+	auto entityManagerData = PrepareEntityManager();
+	EntityManager& entityManager = entityManagerData->entityManager;
+	const std::vector<Entity> entities = addBodies(entityManager, 5);
+
+	EntityManager entityManagerCopy(entityManagerData->componentFactory);
+	entityManagerCopy.overrideBy(entityManager);
+
+	auto [body] = entityManagerCopy.getEntityComponents<BodyComponent>(entities[3]);
+	ASSERT_NE(nullptr, body.hot);
+	ASSERT_NE(nullptr, body.cold);
+	EXPECT_EQ(3.0f, body.hot->x);
+	EXPECT_EQ("body3", body.cold->debugName);
+}
+
+// benchmark, run with --gtest_also_run_disabled_tests
+// updates the hot fields of a large pool through Hot<T>, through full split access, and through an unsplit component
+TEST(EntityManager, DISABLED_Benchmark_SplitComponents_IterateOverHotPartsAndFullComponents)
+{
+	using namespace TestEntityManager_SplitComponents_Internal;
+
+	constexpr int entitiesCount = 1000000;
+	constexpr int passesCount = 50;
+
+	ComponentFactory componentFactory;
+	RegisterComponents(componentFactory);
+	componentFactory.registerComponent<UnsplitBodyComponent>();
+	EntityManager entityManager(componentFactory);
+
+	for (int i = 0; i < entitiesCount; ++i)
+	{
+		const BodyComponent::Hot hot{static_cast<float>(i), 0.0f, 1.0f, 1.0f};
+		const BodyComponent::Cold cold{"body" + std::to_string(i), i, i % 4};
+
+		SplitComponentPtr<BodyComponent> body = entityManager.addComponent<BodyComponent>(entityManager.addEntity());
+		*body.hot = hot;
+		*body.cold = cold;
+
+		UnsplitBodyComponent* unsplitBody = entityManager.addComponent<UnsplitBodyComponent>(entityManager.addEntity());
+		unsplitBody->hot = hot;
+		unsplitBody->cold = cold;
+	}
+
+	const auto hotStartTime = std::chrono::steady_clock::now();
+	for (int pass = 0; pass < passesCount; ++pass)
+	{
+		entityManager.forEachComponentSet<Hot<BodyComponent>>([](BodyComponent::Hot* hot) {
+			hot->x += hot->vx;
+			hot->y += hot->vy;
+		});
+	}
+	const auto hotTime = std::chrono::steady_clock::now() - hotStartTime;
+
+	// a system that asks for the full component and reads one cold field pulls the cold pool through cache too
+	long long ownerIdsSum = 0;
+	const auto fullStartTime = std::chrono::steady_clock::now();
+	for (int pass = 0; pass < passesCount; ++pass)
+	{
+		entityManager.forEachComponentSet<BodyComponent>([&ownerIdsSum](SplitComponentPtr<BodyComponent> body) {
+			body.hot->x += body.hot->vx;
+			body.hot->y += body.hot->vy;
+			ownerIdsSum += body.cold->ownerId;
+		});
+	}
+	const auto fullTime = std::chrono::steady_clock::now() - fullStartTime;
+
+	const auto unsplitStartTime = std::chrono::steady_clock::now();
+	for (int pass = 0; pass < passesCount; ++pass)
+	{
+		entityManager.forEachComponentSet<UnsplitBodyComponent>([](UnsplitBodyComponent* body) {
+			body->hot.x += body->hot.vx;
+			body->hot.y += body->hot.vy;
+		});
+	}
+	const auto unsplitTime = std::chrono::steady_clock::now() - unsplitStartTime;
+
+	const auto bandwidth = [](size_t bytesPerEntity, auto elapsedTime) {
+		const double seconds = std::chrono::duration<double>(elapsedTime).count();
+		return static_cast<double>(bytesPerEntity) * entitiesCount * passesCount / seconds / 1.0e9;
+	};
+
+	std::cout << entitiesCount << " entities, " << passesCount << " passes"
+		<< ", Hot<T> (" << sizeof(BodyComponent::Hot) << " bytes per entity): " << std::chrono::duration_cast<std::chrono::milliseconds>(hotTime).count() << " ms, "
+		<< bandwidth(sizeof(BodyComponent::Hot), hotTime) << " GB/s"
+		<< ", full T (" << sizeof(BodyComponent::Hot) + sizeof(BodyComponent::Cold) << " bytes per entity): " << std::chrono::duration_cast<std::chrono::milliseconds>(fullTime).count() << " ms, "
+		<< bandwidth(sizeof(BodyComponent::Hot) + sizeof(BodyComponent::Cold), fullTime) << " GB/s"
+		<< ", unsplit (" << sizeof(UnsplitBodyComponent) << " bytes per entity): " << std::chrono::duration_cast<std::chrono::milliseconds>(unsplitTime).count() << " ms, "
+		<< bandwidth(sizeof(UnsplitBodyComponent), unsplitTime) << " GB/s"
+		<< " (owner ids sum " << ownerIdsSum << ")"
+		<< std::endl;
+}
@@ -0,0 +1,237 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "raccoon-ecs/entity_manager.h"
+
+namespace TestEntityManager_StructuralChanges_Internal
+{
+	enum ComponentType
+	{
+		TransformComponentId,
+		MovementComponentId,
+	};
+
+	using ComponentFactory = RaccoonEcs::ComponentFactoryImpl<ComponentType>;
+	using EntityManager = RaccoonEcs::EntityManagerImpl<ComponentType>;
+	using Entity = RaccoonEcs::Entity;
+	using Tick = RaccoonEcs::Tick;
+	template<typename T>
+	using Added = RaccoonEcs::Added<T>;
+	template<typename T>
+	using Removed = RaccoonEcs::Removed<T>;
+
+	struct TransformComponent
+	{
+		int x;
+		int y;
+
+		static ComponentType GetTypeId() { return TransformComponentId; };
+	};
+
+	struct MovementComponent
+	{
+		int dx;
+		int dy;
+
+		static ComponentType GetTypeId() { return MovementComponentId; };
+	};
+
+	struct EntityManagerData
+	{
+		ComponentFactory componentFactory;
+		EntityManager entityManager{componentFactory};
+	};
+
+	static void RegisterComponents(ComponentFactory& inOutFactory)
+	{
+		inOutFactory.registerComponent<TransformComponent>();
+		inOutFactory.registerComponent<MovementComponent>();
+	}
+
+	static std::unique_ptr<EntityManagerData> PrepareEntityManager()
+	{
+		auto data = std::make_unique<EntityManagerData>();
+		RegisterComponents(data->componentFactory);
+		return data;
+	}
+
+	static std::vector<Entity> collectAddedTransforms(EntityManager& entityManager, Tick sinceTick)
+	{
+		std::vector<Entity> result;
+		entityManager.forEachComponentSetWithEntity<Added<TransformComponent>>(sinceTick, [&result](Entity entity, TransformComponent* transform) {
+			EXPECT_NE(nullptr, transform);
+			result.push_back(entity);
+		});
+		std::sort(result.begin(), result.end());
+		return result;
+	}
+} // namespace EntityManagerTestInternals
+
+TEST(EntityManager, AddedFilter_AddComponentsAfterTick_OnlyNewComponentsAreVisited)
+{
+	using namespace TestEntityManager_StructuralChanges_Internal;
+
+	auto entityManagerData = PrepareEntityManager();
+	EntityManager& entityManager = entityManagerData->entityManager;
+
+	const Entity oldEntity = entityManager.addEntity();
+	entityManager.addComponent<TransformComponent>(oldEntity);
+
+	const Tick lastRunTick = entityManager.advanceTick();
+
+	const Entity newEntity1 = entityManager.addEntity();
+	entityManager.addComponent<TransformComponent>(newEntity1);
+	const Entity newEntity2 = entityManager.addEntity();
+	entityManager.addComponent<TransformComponent>(newEntity2);
+	entityManager.addComponent<MovementComponent>(oldEntity);
+
+	std::vector<Entity> expectedEntities{newEntity1, newEntity2};
+	std::sort(expectedEntities.begin(), expectedEntities.end());
+	EXPECT_EQ(expectedEntities, collectAddedTransforms(entityManager, lastRunTick));
+
+	const Tick nextRunTick = entityManager.advanceTick();
+	EXPECT_TRUE(collectAddedTransforms(entityManager, nextRunTick).empty());
+	// older ticks still see the changes until the log is trimmed
+	EXPECT_EQ(expectedEntities, collectAddedTransforms(entityManager, lastRunTick));
+}
+
+TEST(EntityManager, AddedFilter_CombinedWithRegularComponent_EntitiesMustHaveBoth)
+{
+	using namespace TestEntityManager_StructuralChanges_Internal;
+
+	auto entityManagerData = PrepareEntityManager();
+	EntityManager& entityManager = entityManagerData->entityManager;
+
+	const Entity entityWithMovement = entityManager.addEntity();
+	entityManager.addComponent<MovementComponent>(entityWithMovement);
+	const Entity entityWithoutMovement = entityManager.addEntity();
+
+	const Tick lastRunTick = entityManager.advanceTick();
+
+	entityManager.addComponent<TransformComponent>(entityWithMovement);
+	entityManager.addComponent<TransformComponent>(entityWithoutMovement);
+
+	int iterationsCount = 0;
+	entityManager.forEachComponentSetWithEntity<Added<TransformComponent>, MovementComponent>(
+		lastRunTick,
+		[&iterationsCount, entityWithMovement](Entity entity, TransformComponent*, MovementComponent*) {
+			EXPECT_EQ(entityWithMovement, entity);
+			++iterationsCount;
+		}
+	);
+	EXPECT_EQ(1, iterationsCount);
+}
+
+TEST(EntityManager, AddedFilter_ComponentAddedAndRemovedAfterTick_ComponentIsNotVisited)
+{
+	using namespace TestEntityManager_StructuralChanges_Internal;
+
+	auto entityManagerData = PrepareEntityManager();
+	EntityManager& entityManager = entityManagerData->entityManager;
+
+	const Entity entity = entityManager.addEntity();
+	const Tick lastRunTick = entityManager.advanceTick();
+
+	entityManager.addComponent<TransformComponent>(entity);
+	entityManager.removeComponent<TransformComponent>(entity);
+
+	EXPECT_TRUE(collectAddedTransforms(entityManager, lastRunTick).empty());
+}
+
+TEST(EntityManager, RemovedFilter_RemoveComponentsAndEntities_FinalValuesAreReadable)
+{
+	using namespace TestEntityManager_StructuralChanges_Internal;
+
+	auto entityManagerData = PrepareEntityManager();
+	EntityManager& entityManager = entityManagerData->entityManager;
+
+	const Entity entity1 = entityManager.addEntity();
+	entityManager.addComponent<TransformComponent>(entity1)->x = 10;
+	const Entity entity2 = entityManager.addEntity();
+	entityManager.addComponent<TransformComponent>(entity2)->x = 20;
+	const Entity entity3 = entityManager.addEntity();
+	entityManager.addComponent<TransformComponent>(entity3)->x = 30;
+
+	const Tick lastRunTick = entityManager.advanceTick();
+
+	// the value at the moment of removal is what gets logged
+	auto [transform1] = entityManager.getEntityComponents<TransformComponent>(entity1);
+	transform1->x = 15;
+	entityManager.removeComponent<TransformComponent>(entity1);
+	entityManager.removeEntity(entity2);
+
+	std::vector<std::pair<Entity, int>> removedComponents;
+	entityManager.forEachComponentSetWithEntity<Removed<TransformComponent>>(lastRunTick, [&removedComponents](Entity entity, const TransformComponent* transform) {
+		removedComponents.emplace_back(entity, transform->x);
+	});
+	std::sort(removedComponents.begin(), removedComponents.end());
+
+	std::vector<std::pair<Entity, int>> expectedComponents{{entity1, 15}, {entity2, 20}};
+	std::sort(expectedComponents.begin(), expectedComponents.end());
+	EXPECT_EQ(expectedComponents, removedComponents);
+	EXPECT_TRUE(entityManager.hasEntity(entity3));
+}
+
+TEST(EntityManager, StructuralChangeLogs_TrimLogs_OlderChangesAreNotVisited)
+{
+	using namespace TestEntityManager_StructuralChanges_Internal;
+
+	auto entityManagerData = PrepareEntityManager();
+	EntityManager& entityManager = entityManagerData->entityManager;
+
+	const Tick firstTick = entityManager.advanceTick();
+	const Entity entity1 = entityManager.addEntity();
+	entityManager.addComponent<TransformComponent>(entity1);
+	entityManager.removeComponent<TransformComponent>(entity1);
+
+	const Tick secondTick = entityManager.advanceTick();
+	const Entity entity2 = entityManager.addEntity();
+	entityManager.addComponent<TransformComponent>(entity2);
+
+	entityManager.trimStructuralChangeLogs(secondTick);
+
+	EXPECT_EQ(std::vector<Entity>{entity2}, collectAddedTransforms(entityManager, firstTick));
+
+	int removedCount = 0;
+	entityManager.forEachComponentSetWithEntity<Removed<TransformComponent>>(firstTick, [&removedCount](Entity, const TransformComponent*) {
+		++removedCount;
+	});
+	EXPECT_EQ(0, removedCount);
+}
+
+TEST(EntityManager, StructuralChangeLogs_ClearKeepingCapacity_LogsAreReset)
+{
+	using namespace TestEntityManager_StructuralChanges_Internal;
+
+	auto entityManagerData = PrepareEntityManager();
+	EntityManager& entityManager = entityManagerData->entityManager;
+
+	const Tick lastRunTick = entityManager.advanceTick();
+
+	std::vector<Entity> entities;
+	for (int i = 0; i < 4; ++i)
+	{
+		const Entity entity = entityManager.addEntity();
+		entityManager.addComponent<TransformComponent>(entity);
+		entities.push_back(entity);
+	}
+	entityManager.removeComponent<TransformComponent>(entities[0]);
+	ASSERT_EQ(static_cast<size_t>(3), collectAddedTransforms(entityManager, lastRunTick).size());
+
+	entityManager.clear(EntityManager::ClearMode::KeepCapacity);
+
+	// the cleared components are neither reported as added nor as removed
+	EXPECT_TRUE(collectAddedTransforms(entityManager, lastRunTick).empty());
+	int removedCount = 0;
+	entityManager.forEachComponentSetWithEntity<Removed<TransformComponent>>(lastRunTick, [&removedCount](Entity, const TransformComponent*) {
+		++removedCount;
+	});
+	EXPECT_EQ(0, removedCount);
+
+	// the logs keep working for the repopulated world
+	const Entity newEntity = entityManager.addEntity();
+	entityManager.addComponent<TransformComponent>(newEntity);
+	EXPECT_EQ(std::vector<Entity>{newEntity}, collectAddedTransforms(entityManager, lastRunTick));
+}
@@ -0,0 +1,274 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "raccoon-ecs/entity_manager.h"
+#include "raccoon-ecs/error_handling.h"
+
+namespace TestEntityManager_UniqueIndexes_Internal
+{
+	enum ComponentType
+	{
+		NameComponentId,
+		TransformComponentId,
+	};
+
+	using ComponentFactory = RaccoonEcs::ComponentFactoryImpl<ComponentType>;
+	using EntityManager = RaccoonEcs::EntityManagerImpl<ComponentType>;
+	using Entity = RaccoonEcs::Entity;
+	using OptionalEntity = RaccoonEcs::OptionalEntity;
+
+	struct NameComponent
+	{
+		std::string id;
+
+		static ComponentType GetTypeId() { return NameComponentId; };
+	};
+
+	struct TransformComponent
+	{
+		int x;
+		int y;
+
+		static ComponentType GetTypeId() { return TransformComponentId; };
+	};
+
+	struct EntityManagerData
+	{
+		ComponentFactory componentFactory;
+		EntityManager entityManager{componentFactory};
+	};
+
+	static void RegisterComponents(ComponentFactory& inOutFactory)
+	{
+		inOutFactory.registerComponent<NameComponent>();
+		inOutFactory.registerComponent<TransformComponent>();
+	}
+
+	static std::unique_ptr<EntityManagerData> PrepareEntityManager()
+	{
+		auto data = std::make_unique<EntityManagerData>();
+		RegisterComponents(data->componentFactory);
+		data->entityManager.initUniqueIndex<NameComponent>(&NameComponent::id);
+		return data;
+	}
+
+	// the key is indexed before addComponent returns, so it has to be set by the initializer
+	static Entity addNamedEntity(EntityManager& entityManager, const std::string& id)
+	{
+		const Entity entity = entityManager.addEntity();
+		entityManager.addComponent<NameComponent>(entity, [&id](NameComponent* name) {
+			name->id = id;
+		});
+		return entity;
+	}
+
+	static int gReportedErrorsCount = 0;
+} // namespace EntityManagerTestInternals
+
+TEST(EntityManager, EntityManagerWithUniqueIndex_FindEntityByKey_ReturnsEntity)
+{
+	using namespace TestEntityManager_UniqueIndexes_Internal;
+
+	auto entityManagerData = PrepareEntityManager();
+	EntityManager& entityManager = entityManagerData->entityManager;
+
+	const Entity entity1 = addNamedEntity(entityManager, "first");
+	const Entity entity2 = addNamedEntity(entityManager, "second");
+
+	EXPECT_EQ(entity1, entityManager.findEntityBy<NameComponent>(std::string("first")));
+	EXPECT_EQ(entity2, entityManager.findEntityBy<NameComponent>(std::string("second")));
+	EXPECT_FALSE(entityManager.findEntityBy<NameComponent>(std::string("third")).isValid());
+}
+
+TEST(EntityManager, EntityManagerWithUniqueIndex_FindEntityAfterBurstOfAdditions_AllKeysAreFound)
+{
+	using namespace TestEntityManager_UniqueIndexes_Internal;
+
+	auto entityManagerData = PrepareEntityManager();
+	EntityManager& entityManager = entityManagerData->entityManager;
+
+	std::vector<Entity> entities;
+	for (int i = 0; i < 1000; ++i)
+	{
+		entities.push_back(addNamedEntity(entityManager, "entity" + std::to_string(i)));
+	}
+
+	// every key was indexed by its addComponent call, so no lookup has to catch up on the additions
+	EXPECT_EQ(entities[999], entityManager.findEntityBy<NameComponent>(std::string("entity999")));
+	EXPECT_EQ(entities[0], entityManager.findEntityBy<NameComponent>(std::string("entity0")));
+	EXPECT_EQ(entities[500], entityManager.findEntityBy<NameComponent>(std::string("entity500")));
+}
+
+TEST(EntityManager, EntityManagerWithUniqueIndex_InitIndexAfterAddingComponents_ExistingComponentsAreIndexed)
+{
+	using namespace TestEntityManager_UniqueIndexes_Internal;
+
+	ComponentFactory componentFactory;
+	RegisterComponents(componentFactory);
+	EntityManager entityManager(componentFactory);
+
+	const Entity entity = addNamedEntity(entityManager, "first");
+	entityManager.initUniqueIndex<NameComponent>(&NameComponent::id);
+
+	EXPECT_EQ(entity, entityManager.findEntityBy<NameComponent>(std::string("first")));
+}
+
+TEST(EntityManager, EntityManagerWithUniqueIndex_RemoveComponentOrEntity_KeyIsNotFound)
+{
+	using namespace TestEntityManager_UniqueIndexes_Internal;
+
+	auto entityManagerData = PrepareEntityManager();
+	EntityManager& entityManager = entityManagerData->entityManager;
+
+	const Entity entity1 = addNamedEntity(entityManager, "first");
+	const Entity entity2 = addNamedEntity(entityManager, "second");
+	const Entity entity3 = addNamedEntity(entityManager, "third");
+
+	entityManager.removeComponent<NameComponent>(entity1);
+	entityManager.removeEntity(entity2);
+
+	EXPECT_FALSE(entityManager.findEntityBy<NameComponent>(std::string("first")).isValid());
+	EXPECT_FALSE(entityManager.findEntityBy<NameComponent>(std::string("second")).isValid());
+	EXPECT_EQ(entity3, entityManager.findEntityBy<NameComponent>(std::string("third")));
+
+	// keys can be reused after being released
+	const Entity entity4 = addNamedEntity(entityManager, "first");
+	EXPECT_EQ(entity4, entityManager.findEntityBy<NameComponent>(std::string("first")));
+}
+
+TEST(EntityManager, EntityManagerWithUniqueIndex_ModifyComponent_KeyIsUpdated)
+{
+	using namespace TestEntityManager_UniqueIndexes_Internal;
+
+	auto entityManagerData = PrepareEntityManager();
+	EntityManager& entityManager = entityManagerData->entityManager;
+
+	const Entity entity = addNamedEntity(entityManager, "first");
+
+	entityManager.modifyComponent<NameComponent>(entity, [](NameComponent* name) {
+		name->id = "renamed";
+	});
+
+	EXPECT_FALSE(entityManager.findEntityBy<NameComponent>(std::string("first")).isValid());
+	EXPECT_EQ(entity, entityManager.findEntityBy<NameComponent>(std::string("renamed")));
+}
+
+TEST(EntityManager, EntityManagerWithUniqueIndex_CloneEntityManager_IndexIsCopied)
+{
+	using namespace TestEntityManager_UniqueIndexes_Internal;
+
+	auto entityManagerData = PrepareEntityManager();
+	EntityManager& entityManager = entityManagerData->entityManager;
+
+	const Entity entity = addNamedEntity(entityManager, "first");
+
+	EntityManager entityManagerCopy(entityManagerData->componentFactory);
+	addNamedEntity(entityManagerCopy, "old");
+	entityManagerCopy.initUniqueIndex<NameComponent>(&NameComponent::id);
+
+	entityManagerCopy.overrideBy(entityManager);
+
+	EXPECT_EQ(entity, entityManagerCopy.findEntityBy<NameComponent>(std::string("first")));
+	EXPECT_FALSE(entityManagerCopy.findEntityBy<NameComponent>(std::string("old")).isValid());
+}
+
+TEST(EntityManager, EntityManagerWithUniqueIndex_TransferEntityToAnotherManager_KeyIsMoved)
+{
+	using namespace TestEntityManager_UniqueIndexes_Internal;
+
+	auto entityManagerData = PrepareEntityManager();
+	EntityManager& entityManager1 = entityManagerData->entityManager;
+	EntityManager entityManager2(entityManagerData->componentFactory);
+	entityManager2.initUniqueIndex<NameComponent>(&NameComponent::id);
+
+	const Entity entity = addNamedEntity(entityManager1, "first");
+
+	const Entity transferredEntity = entityManager1.transferEntityTo(entityManager2, entity);
+
+	EXPECT_FALSE(entityManager1.findEntityBy<NameComponent>(std::string("first")).isValid());
+	EXPECT_EQ(transferredEntity, entityManager2.findEntityBy<NameComponent>(std::string("first")));
+}
+
+TEST(EntityManager, EntityManagerWithUniqueIndex_ScheduleAddComponent_KeyIsIndexedWhenActionsAreExecuted)
+{
+	using namespace TestEntityManager_UniqueIndexes_Internal;
+
+	auto entityManagerData = PrepareEntityManager();
+	EntityManager& entityManager = entityManagerData->entityManager;
+
+	const Entity entity = entityManager.addEntity();
+	entityManager.scheduleAddComponent<NameComponent>(entity)->id = "scheduled";
+
+	EXPECT_FALSE(entityManager.findEntityBy<NameComponent>(std::string("scheduled")).isValid());
+
+	// the component, with the key written into it, is added and indexed by executeScheduledActions
+	entityManager.executeScheduledActions();
+	EXPECT_EQ(entity, entityManager.findEntityBy<NameComponent>(std::string("scheduled")));
+}
+
+#ifdef RACCOON_ECS_DEBUG_CHECKS_ENABLED
+TEST(EntityManager, EntityManagerWithUniqueIndex_AddDuplicateKey_ErrorIsReported)
+{
+	using namespace TestEntityManager_UniqueIndexes_Internal;
+
+	auto entityManagerData = PrepareEntityManager();
+	EntityManager& entityManager = entityManagerData->entityManager;
+
+	const Entity firstEntity = addNamedEntity(entityManager, "first");
+
+	const auto previousErrorHandler = RaccoonEcs::gErrorHandler;
+	gReportedErrorsCount = 0;
+	RaccoonEcs::gErrorHandler = [](const std::string&) { ++gReportedErrorsCount; };
+
+	// the duplicate is reported by the addComponent call that introduced it
+	addNamedEntity(entityManager, "first");
+	const int errorsCountAfterAdding = gReportedErrorsCount;
+
+	// the duplicate is not indexed, the key keeps pointing to the entity that had it first
+	const OptionalEntity foundEntity = entityManager.findEntityBy<NameComponent>(std::string("first"));
+	const int errorsCountAfterLookup = gReportedErrorsCount;
+
+	RaccoonEcs::gErrorHandler = previousErrorHandler;
+
+	EXPECT_EQ(1, errorsCountAfterAdding);
+	EXPECT_EQ(1, errorsCountAfterLookup);
+	EXPECT_EQ(firstEntity, foundEntity);
+}
+
+TEST(EntityManager, EntityManagerWithUniqueIndex_AddComponentsWithoutInitializer_KeysAreIndexedOnModify)
+{
+	using namespace TestEntityManager_UniqueIndexes_Internal;
+
+	auto entityManagerData = PrepareEntityManager();
+	EntityManager& entityManager = entityManagerData->entityManager;
+
+	const auto previousErrorHandler = RaccoonEcs::gErrorHandler;
+	gReportedErrorsCount = 0;
+	RaccoonEcs::gErrorHandler = [](const std::string&) { ++gReportedErrorsCount; };
+
+	// components added without an initializer have no key yet, so their empty ids don't collide
+	const Entity entity1 = entityManager.addEntity();
+	entityManager.addComponent<NameComponent>(entity1);
+	const Entity entity2 = entityManager.addEntity();
+	entityManager.addComponent<NameComponent>(entity2)->id = "written directly";
+	const int errorsCountAfterAdding = gReportedErrorsCount;
+
+	const bool isEmptyKeyFound = entityManager.findEntityBy<NameComponent>(std::string()).isValid();
+	const bool isDirectlyWrittenKeyFound = entityManager.findEntityBy<NameComponent>(std::string("written directly")).isValid();
+
+	// the key is indexed once it is set through the tracked setter
+	entityManager.modifyComponent<NameComponent>(entity1, [](NameComponent* name) {
+		name->id = "late";
+	});
+
+	RaccoonEcs::gErrorHandler = previousErrorHandler;
+
+	EXPECT_EQ(0, errorsCountAfterAdding);
+	EXPECT_FALSE(isEmptyKeyFound);
+	EXPECT_FALSE(isDirectlyWrittenKeyFound);
+	EXPECT_EQ(0, gReportedErrorsCount);
+	EXPECT_EQ(entity1, entityManager.findEntityBy<NameComponent>(std::string("late")));
+}
+#endif // RACCOON_ECS_DEBUG_CHECKS_ENABLED
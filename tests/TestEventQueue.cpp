@@ -0,0 +1,186 @@
+#include <gtest/gtest.h>
+
+#include <map>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include "raccoon-ecs/entity_manager.h"
+#include "raccoon-ecs/event_queue.h"
+
+namespace TestEventQueue_Internal
+{
+	enum ComponentType
+	{
+		HealthComponentId,
+	};
+
+	using ComponentFactory = RaccoonEcs::ComponentFactoryImpl<ComponentType>;
+	using EntityManager = RaccoonEcs::EntityManagerImpl<ComponentType>;
+	using Entity = RaccoonEcs::Entity;
+
+	struct HealthComponent
+	{
+		int health;
+
+		static ComponentType GetTypeId() { return HealthComponentId; };
+	};
+
+	struct DamageEvent
+	{
+		int damage;
+		int producerIndex;
+	};
+} // namespace EntityManagerTestInternals
+
+TEST(EventQueue, EventsPushed_BeforeSwap_EventsAreNotVisible)
+{
+	using namespace TestEventQueue_Internal;
+
+	RaccoonEcs::EventQueue<DamageEvent> queue;
+
+	queue.push(DamageEvent{10, 0});
+	queue.push(DamageEvent{20, 0});
+
+	EXPECT_TRUE(queue.getEvents().empty());
+}
+
+TEST(EventQueue, EventsPushed_Swap_EventsAreVisibleForOneFrame)
+{
+	using namespace TestEventQueue_Internal;
+
+	RaccoonEcs::EventQueue<DamageEvent> queue;
+
+	queue.push(DamageEvent{10, 0});
+	queue.push(DamageEvent{20, 0});
+	queue.swapBuffers();
+
+	{
+		const std::span<const DamageEvent> events = queue.getEvents();
+		ASSERT_EQ(static_cast<size_t>(2), events.size());
+		EXPECT_EQ(10, events[0].damage);
+		EXPECT_EQ(20, events[1].damage);
+	}
+
+	// events pushed while consuming go to the next frame
+	queue.push(DamageEvent{30, 0});
+	EXPECT_EQ(static_cast<size_t>(2), queue.getEvents().size());
+
+	queue.swapBuffers();
+
+	{
+		const std::span<const DamageEvent> events = queue.getEvents();
+		ASSERT_EQ(static_cast<size_t>(1), events.size());
+		EXPECT_EQ(30, events[0].damage);
+	}
+
+	queue.swapBuffers();
+	EXPECT_TRUE(queue.getEvents().empty());
+}
+
+TEST(EventQueue, EventsPushedFromMultipleThreads_Swap_AllEventsAreVisibleInProducerOrder)
+{
+	using namespace TestEventQueue_Internal;
+
+	RaccoonEcs::EventQueue<DamageEvent> queue;
+
+	constexpr int threadsCount = 4;
+	constexpr int eventsPerThread = 1000;
+
+	std::vector<std::thread> threads;
+	for (int threadIndex = 0; threadIndex < threadsCount; ++threadIndex)
+	{
+		threads.emplace_back([&queue, threadIndex]() {
+			for (int i = 0; i < eventsPerThread; ++i)
+			{
+				queue.push(DamageEvent{i, threadIndex});
+			}
+		});
+	}
+
+	for (std::thread& thread : threads)
+	{
+		thread.join();
+	}
+
+	queue.swapBuffers();
+
+	const std::span<const DamageEvent> events = queue.getEvents();
+	ASSERT_EQ(static_cast<size_t>(threadsCount * eventsPerThread), events.size());
+
+	// order between producers is not defined, but events of one producer keep their order
+	std::map<int, int> nextExpectedDamage;
+	for (const DamageEvent& event : events)
+	{
+		EXPECT_EQ(nextExpectedDamage[event.producerIndex], event.damage);
+		nextExpectedDamage[event.producerIndex] = event.damage + 1;
+	}
+}
+
+TEST(EntityEventQueue, EventsPushedForEntities_ForEachEntityGroup_EventsAreGroupedByEntity)
+{
+	using namespace TestEventQueue_Internal;
+
+	ComponentFactory componentFactory;
+	componentFactory.registerComponent<HealthComponent>();
+	EntityManager entityManager(componentFactory);
+
+	const Entity entity1 = entityManager.addEntity();
+	const Entity entity2 = entityManager.addEntity();
+
+	RaccoonEcs::EntityEventQueue<DamageEvent> queue;
+	queue.push(entity1, DamageEvent{10, 0});
+	queue.push(entity2, DamageEvent{20, 0});
+	queue.push(entity1, DamageEvent{30, 0});
+	queue.swapBuffers();
+
+	EXPECT_EQ(static_cast<size_t>(3), queue.getEvents().size());
+
+	std::map<Entity, std::vector<int>> groupedDamage;
+	int groupsCount = 0;
+	queue.forEachEntityGroup([&groupedDamage, &groupsCount](Entity entity, std::span<const DamageEvent> events) {
+		++groupsCount;
+		for (const DamageEvent& event : events)
+		{
+			groupedDamage[entity].push_back(event.damage);
+		}
+	});
+
+	EXPECT_EQ(2, groupsCount);
+	EXPECT_EQ(std::vector<int>({10, 30}), groupedDamage[entity1]);
+	EXPECT_EQ(std::vector<int>({20}), groupedDamage[entity2]);
+}
+
+TEST(EntityEventQueue, EventsPushedForRemovedEntity_ForEachEntityGroupInManager_RemovedEntityIsSkipped)
+{
+	using namespace TestEventQueue_Internal;
+
+	ComponentFactory componentFactory;
+	componentFactory.registerComponent<HealthComponent>();
+	EntityManager entityManager(componentFactory);
+
+	const Entity entity1 = entityManager.addEntity();
+	entityManager.addComponent<HealthComponent>(entity1)->health = 100;
+	const Entity entity2 = entityManager.addEntity();
+	entityManager.addComponent<HealthComponent>(entity2)->health = 100;
+
+	RaccoonEcs::EntityEventQueue<DamageEvent> queue;
+	queue.push(entity1, DamageEvent{10, 0});
+	queue.push(entity2, DamageEvent{20, 0});
+	queue.push(entity1, DamageEvent{30, 0});
+	queue.swapBuffers();
+
+	entityManager.removeEntity(entity2);
+
+	queue.forEachEntityGroup(entityManager, [&entityManager](Entity entity, std::span<const DamageEvent> events) {
+		auto [health] = entityManager.getEntityComponents<HealthComponent>(entity);
+		ASSERT_NE(nullptr, health);
+		for (const DamageEvent& event : events)
+		{
+			health->health -= event.damage;
+		}
+	});
+
+	auto [health] = entityManager.getEntityComponents<HealthComponent>(entity1);
+	EXPECT_EQ(60, health->health);
+}
@@ -0,0 +1,102 @@
+#include "tests/utils/allocation_counter.h"
+
+#include <cstdlib>
+#include <new>
+
+namespace AllocationCounter
+{
+	// per-thread, so allocations made by gtest or by unrelated threads don't leak into the measurements
+	static thread_local size_t gAllocationsCount = 0;
+	static thread_local size_t gDeallocationsCount = 0;
+
+	size_t GetAllocationsCount()
+	{
+		return gAllocationsCount;
+	}
+
+	size_t GetDeallocationsCount()
+	{
+		return gDeallocationsCount;
+	}
+
+	static void* Allocate(size_t size)
+	{
+		++gAllocationsCount;
+		return std::malloc(size == 0 ? 1 : size);
+	}
+
+	static void* AllocateAligned(size_t size, std::align_val_t alignment)
+	{
+		++gAllocationsCount;
+		const size_t alignmentValue = static_cast<size_t>(alignment);
+#ifdef _MSC_VER
+		return _aligned_malloc(size == 0 ? 1 : size, alignmentValue);
+#else
+		// aligned_alloc requires the size to be a multiple of the alignment
+		const size_t alignedSize = ((size + alignmentValue - 1) / alignmentValue) * alignmentValue;
+		return std::aligned_alloc(alignmentValue, alignedSize == 0 ? alignmentValue : alignedSize);
+#endif
+	}
+
+	static void Deallocate(void* pointer)
+	{
+		if (pointer != nullptr)
+		{
+			++gDeallocationsCount;
+			std::free(pointer);
+		}
+	}
+
+	static void DeallocateAligned(void* pointer)
+	{
+		if (pointer != nullptr)
+		{
+			++gDeallocationsCount;
+#ifdef _MSC_VER
+			_aligned_free(pointer);
+#else
+			std::free(pointer);
+#endif
+		}
+	}
+
+	static void* AllocateOrThrow(size_t size)
+	{
+		if (void* pointer = Allocate(size))
+		{
+			return pointer;
+		}
+		throw std::bad_alloc();
+	}
+
+	static void* AllocateAlignedOrThrow(size_t size, std::align_val_t alignment)
+	{
+		if (void* pointer = AllocateAligned(size, alignment))
+		{
+			return pointer;
+		}
+		throw std::bad_alloc();
+	}
+}
+
+void* operator new(size_t size) { return AllocationCounter::AllocateOrThrow(size); }
+void* operator new[](size_t size) { return AllocationCounter::AllocateOrThrow(size); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return AllocationCounter::Allocate(size); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return AllocationCounter::Allocate(size); }
+void* operator new(size_t size, std::align_val_t alignment) { return AllocationCounter::AllocateAlignedOrThrow(size, alignment); }
+void* operator new[](size_t size, std::align_val_t alignment) { return AllocationCounter::AllocateAlignedOrThrow(size, alignment); }
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return AllocationCounter::AllocateAligned(size, alignment); }
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return AllocationCounter::AllocateAligned(size, alignment); }
+
+void operator delete(void* pointer) noexcept { AllocationCounter::Deallocate(pointer); }
+void operator delete[](void* pointer) noexcept { AllocationCounter::Deallocate(pointer); }
+void operator delete(void* pointer, size_t) noexcept { AllocationCounter::Deallocate(pointer); }
+void operator delete[](void* pointer, size_t) noexcept { AllocationCounter::Deallocate(pointer); }
+void operator delete(void* pointer, const std::nothrow_t&) noexcept { AllocationCounter::Deallocate(pointer); }
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept { AllocationCounter::Deallocate(pointer); }
+void operator delete(void* pointer, std::align_val_t) noexcept { AllocationCounter::DeallocateAligned(pointer); }
+void operator delete[](void* pointer, std::align_val_t) noexcept { AllocationCounter::DeallocateAligned(pointer); }
+void operator delete(void* pointer, size_t, std::align_val_t) noexcept { AllocationCounter::DeallocateAligned(pointer); }
+void operator delete[](void* pointer, size_t, std::align_val_t) noexcept { AllocationCounter::DeallocateAligned(pointer); }
+void operator delete(void* pointer, std::align_val_t, const std::nothrow_t&) noexcept { AllocationCounter::DeallocateAligned(pointer); }
+void operator delete[](void* pointer, std::align_val_t, const std::nothrow_t&) noexcept { AllocationCounter::DeallocateAligned(pointer); }
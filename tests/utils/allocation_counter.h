@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstddef>
+
+// Replaces global operator new/delete for the test executable and counts heap allocations
+// of the calling thread so tests can assert that a code path doesn't allocate
+namespace AllocationCounter
+{
+	size_t GetAllocationsCount();
+	size_t GetDeallocationsCount();
+
+	// counts allocations made by the current thread during the lifetime of the object
+	class ScopedAllocationCounter
+	{
+	public:
+		ScopedAllocationCounter()
+			: mAllocationsAtStart(GetAllocationsCount())
+			, mDeallocationsAtStart(GetDeallocationsCount())
+		{}
+
+		size_t getAllocationsCount() const { return GetAllocationsCount() - mAllocationsAtStart; }
+		size_t getDeallocationsCount() const { return GetDeallocationsCount() - mDeallocationsAtStart; }
+
+	private:
+		size_t mAllocationsAtStart;
+		size_t mDeallocationsAtStart;
+	};
+}